@@ -0,0 +1,482 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "tetris_ai.h"
+
+// Bewertung einer Stellung, in der der nächste Stein nicht mehr passt
+#define AI_SCORE_DEAD (INT_MIN / 2)
+
+// Eintrag der Transpositionstabelle ohne Lock: check ist key ^ data. Lesen
+// zwei Threads gleichzeitig mit einem Schreiber, passt bei einem halb
+// geschriebenen Eintrag check nicht mehr zum Schlüssel und er gilt als leer.
+typedef struct
+{
+    atomic_uint_fast64_t check;
+    atomic_uint_fast64_t data; // Bewertung (untere 32 Bit) und Tiefe
+} AiTableEntry;
+
+// Was die Suche unterhalb der Wurzel braucht
+typedef struct
+{
+    const GameState *g;
+    AiTableEntry *table; // NULL = ohne Tabelle
+    uint64_t base_key;   // Hold nach dem ersten Zug und Seed
+    int next;            // Vorschau-Index des ersten Steins nach der Wurzel
+    int depth;           // Weitere Steine nach der Wurzel
+} AiSearch;
+
+// Ein Auftrag für den Pool: alle Spalten einer Rotation eines Steins
+typedef struct
+{
+    const GameState *g;
+    Tetromino start; // Ausgangslage (aktueller Stein oder nach Hold)
+    int use_hold;
+    int rotation;
+    AiSearch search;
+    AiPlacement best; // Ergebnis, best.score == INT_MIN = nichts gefunden
+} AiJob;
+
+#define AI_MAX_JOBS 8
+
+struct AiPool
+{
+    pthread_t *threads;
+    int thread_count;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+
+    AiJob *jobs;
+    int job_count;
+    int next_job;
+    int jobs_done;
+    unsigned generation; // Wird pro Suche erhöht, weckt die Worker
+    int stop;
+
+    int depth;
+    AiTableEntry *table; // 2^AI_TABLE_BITS Einträge
+};
+
+int ai_evaluate(const uint16_t rows[HEIGHT], int lines)
+{
+    int heights[WIDTH] = {0};
+    int holes = 0;
+    uint16_t seen = 0; // Spalten, in denen weiter oben schon ein Block ist
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        uint16_t row = rows[y];
+        uint16_t fresh = row & ~seen;
+        if (fresh)
+        {
+            for (int x = 0; x < WIDTH; x++)
+            {
+                if (fresh & (1u << x))
+                    heights[x] = HEIGHT - y;
+            }
+        }
+
+        uint16_t empty = ~row & seen & FULL_ROW;
+        while (empty)
+        {
+            holes++;
+            empty &= empty - 1;
+        }
+        seen |= row;
+    }
+
+    int aggregate = 0;
+    int bumpiness = 0;
+    for (int x = 0; x < WIDTH; x++)
+    {
+        aggregate += heights[x];
+        if (x > 0)
+            bumpiness += abs(heights[x] - heights[x - 1]);
+    }
+
+    return AI_WEIGHT_HEIGHT * aggregate + AI_WEIGHT_LINES * lines +
+           AI_WEIGHT_HOLES * holes + AI_WEIGHT_BUMPINESS * bumpiness;
+}
+
+// Stein auf einer Kopie der Zeilen einrasten und volle Zeilen entfernen;
+// gibt die Anzahl gelöschter Zeilen zurück
+static int place_on_rows(uint16_t rows[HEIGHT], const Tetromino *t)
+{
+    rows_merge(rows, t);
+    return __builtin_popcountll(rows_clear(rows));
+}
+
+// Auf die Zielrotation drehen wie im Spiel (mit Wall Kicks); drei
+// Drehungen im Uhrzeigersinn sind eine dagegen. 0, wenn es nicht geht.
+static int rotate_to(const GameState *g, Tetromino *t, int rotation)
+{
+    int dir = rotation == 3 ? -1 : 1;
+    int turns = rotation == 3 ? 1 : rotation;
+    for (int r = 0; r < turns; r++)
+    {
+        if (!rotate_tetromino(g, t, dir))
+            return 0;
+    }
+    return 1;
+}
+
+static int table_probe(const AiTableEntry *table, uint64_t key, int depth, int *score)
+{
+    const AiTableEntry *e = &table[key & ((1u << AI_TABLE_BITS) - 1)];
+    uint64_t data = atomic_load_explicit(&e->data, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&e->check, memory_order_relaxed);
+
+    if ((check ^ data) != key || (int)(data >> 32) != depth)
+        return 0;
+    *score = (int32_t)(uint32_t)data;
+    return 1;
+}
+
+// Immer ersetzen: die jüngste Suche braucht die Einträge am ehesten wieder
+static void table_store(AiTableEntry *table, uint64_t key, int depth, int score)
+{
+    AiTableEntry *e = &table[key & ((1u << AI_TABLE_BITS) - 1)];
+    uint64_t data = (uint64_t)depth << 32 | (uint32_t)score;
+
+    atomic_store_explicit(&e->data, data, memory_order_relaxed);
+    atomic_store_explicit(&e->check, key ^ data, memory_order_relaxed);
+}
+
+// Zobrist Schlüssel der Zellen eines Steins, so wie place_on_rows ihn setzt
+static uint64_t piece_hash(const Tetromino *t)
+{
+    const PieceRotation *p = &piece_table[t->type][t->rotation % 4];
+    uint64_t hash = 0;
+
+    for (int k = 0; k < 4; k++)
+    {
+        int y = t->y + p->cells[k][0];
+        if (y >= 0)
+            hash ^= zobrist_cells[y][t->x + p->cells[k][1]];
+    }
+    return hash;
+}
+
+// Beste Bewertung für den Vorschau-Stein pos auf rows (Zobrist Hash hash)
+// und depth - 1 weitere Steine danach. Gezogen wird wie an der Wurzel
+// jede Rotation und Spalte, aber ohne Wall Kicks und ohne Hold.
+static int search(const AiSearch *s, const uint16_t rows[HEIGHT], uint64_t hash, int pos, int depth)
+{
+    // Stellung = Belegung, Hold und Position in der Steinfolge; der Seed
+    // steckt in base_key, weil die Steine an ihm hängen
+    uint64_t key = hash ^ s->base_key ^ zobrist_queue(s->g->queue_head + pos);
+    int best = AI_SCORE_DEAD;
+    if (s->table && table_probe(s->table, key, depth, &best))
+        return best;
+
+    uint8_t heights[WIDTH];
+    rows_heights(rows, heights);
+
+    int type = peek_piece(s->g, pos);
+    for (int r = 0; r < 4; r++)
+    {
+        Tetromino t = spawn_tetromino(type);
+        t.rotation = r;
+
+        for (int dir = -1; dir <= 1; dir += 2)
+        {
+            Tetromino column = t;
+            if (dir == 1)
+                column.x++;
+
+            for (; !rows_collide(rows, &column); column.x += dir)
+            {
+                Tetromino drop = column;
+                drop.y += rows_drop_distance(rows, heights, &drop);
+
+                uint16_t child[HEIGHT];
+                memcpy(child, rows, sizeof(child));
+                int lines = place_on_rows(child, &drop);
+
+                int score;
+                if (depth == 1)
+                    score = ai_evaluate(child, lines);
+                else
+                {
+                    // Ohne gelöschte Linien reicht es, die Zellen des Steins
+                    // einzurechnen; sonst sind die Zeilen verschoben
+                    uint64_t child_hash = lines ? zobrist_rows(child) : hash ^ piece_hash(&drop);
+                    score = AI_WEIGHT_LINES * lines + search(s, child, child_hash, pos + 1, depth - 1);
+                }
+                if (score > best)
+                    best = score;
+            }
+        }
+    }
+
+    if (s->table)
+        table_store(s->table, key, depth, best);
+    return best;
+}
+
+static void run_job(AiJob *job)
+{
+    const GameState *g = job->g;
+    Tetromino t = job->start;
+
+    job->best.score = INT_MIN;
+    if (!rotate_to(g, &t, job->rotation))
+        return;
+
+    // Nach links bis zur Wand, dabei jede erreichte Spalte bewerten, dann
+    // dasselbe nach rechts
+    for (int dir = -1; dir <= 1; dir += 2)
+    {
+        Tetromino column = t;
+        if (dir == 1)
+            column.x++;
+
+        while (!check_collision(g, &column))
+        {
+            Tetromino drop = column;
+            drop.y += drop_distance(g, &drop);
+
+            uint16_t rows[HEIGHT];
+            memcpy(rows, g->board_rows, sizeof(rows));
+            int lines = place_on_rows(rows, &drop);
+            int score;
+            if (job->search.depth == 0)
+                score = ai_evaluate(rows, lines);
+            else
+            {
+                uint64_t hash = lines ? zobrist_rows(rows) : g->board_hash ^ piece_hash(&drop);
+                score = AI_WEIGHT_LINES * lines +
+                        search(&job->search, rows, hash, job->search.next, job->search.depth);
+            }
+
+            if (score > job->best.score)
+            {
+                job->best.score = score;
+                job->best.use_hold = job->use_hold;
+                job->best.rotation = job->rotation;
+                job->best.x = column.x;
+            }
+
+            column.x += dir;
+        }
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    AiPool *pool = arg;
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1)
+    {
+        while (!pool->stop && (pool->generation == seen || pool->next_job >= pool->job_count))
+        {
+            if (pool->generation != seen)
+                seen = pool->generation; // Runde schon leer
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->stop)
+            break;
+
+        seen = pool->generation;
+        while (pool->next_job < pool->job_count)
+        {
+            AiJob *job = &pool->jobs[pool->next_job++];
+            pthread_mutex_unlock(&pool->lock);
+            run_job(job);
+            pthread_mutex_lock(&pool->lock);
+            if (++pool->jobs_done == pool->job_count)
+                pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+AiPool *ai_pool_create(int threads, int depth)
+{
+    AiPool *pool = calloc(1, sizeof(AiPool));
+    if (!pool)
+        return NULL;
+
+    pool->depth = depth < 1 ? 1 : depth > AI_MAX_DEPTH ? AI_MAX_DEPTH : depth;
+    if (pool->depth > 1)
+    {
+        pool->table = calloc((size_t)1 << AI_TABLE_BITS, sizeof(AiTableEntry));
+        if (!pool->table)
+        {
+            free(pool);
+            return NULL;
+        }
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    // Der aufrufende Thread arbeitet mit, daher einer weniger
+    if (threads > 1)
+    {
+        pool->threads = malloc((threads - 1) * sizeof(pthread_t));
+        for (int i = 0; i < threads - 1; i++)
+        {
+            if (pthread_create(&pool->threads[pool->thread_count], NULL, worker_main, pool) == 0)
+                pool->thread_count++;
+        }
+    }
+    return pool;
+}
+
+void ai_pool_destroy(AiPool *pool)
+{
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->work_done);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool->table);
+    free(pool);
+}
+
+int ai_pool_threads(const AiPool *pool)
+{
+    return pool ? pool->thread_count + 1 : 1;
+}
+
+// Alle Aufträge abarbeiten; der aufrufende Thread hilft mit
+static void run_jobs(AiPool *pool, AiJob *jobs, int count)
+{
+    if (!pool || pool->thread_count == 0)
+    {
+        for (int i = 0; i < count; i++)
+            run_job(&jobs[i]);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->jobs = jobs;
+    pool->job_count = count;
+    pool->next_job = 0;
+    pool->jobs_done = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+
+    while (pool->next_job < pool->job_count)
+    {
+        AiJob *job = &pool->jobs[pool->next_job++];
+        pthread_mutex_unlock(&pool->lock);
+        run_job(job);
+        pthread_mutex_lock(&pool->lock);
+        pool->jobs_done++;
+    }
+    while (pool->jobs_done < pool->job_count)
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+
+    pool->job_count = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Ausgangslage nach Hold: gehaltener Stein oder, wenn noch keiner
+// gehalten wird, der nächste aus der Vorschau
+static Tetromino hold_start(const GameState *g)
+{
+    return spawn_tetromino(g->hold_piece >= 0 ? g->hold_piece : peek_piece(g, 0));
+}
+
+int ai_find_best(AiPool *pool, const GameState *g, AiPlacement *best)
+{
+    AiJob jobs[AI_MAX_JOBS];
+    int count = 0;
+    int depth = pool ? pool->depth : 1;
+
+    for (int use_hold = 0; use_hold <= 1; use_hold++)
+    {
+        if (use_hold && !g->can_hold)
+            break;
+
+        Tetromino start = use_hold ? hold_start(g) : g->current;
+        if (use_hold && check_collision(g, &start))
+            break;
+
+        // Nach Hold mit leerem Hold-Platz ist der nächste Stein schon
+        // verbraucht; tiefer als die Vorschau geht es nicht
+        AiSearch search;
+        search.g = g;
+        search.table = pool ? pool->table : NULL;
+        search.next = use_hold && g->hold_piece < 0 ? 1 : 0;
+        search.depth = depth - 1;
+        if (search.depth > g->queue_count - search.next)
+            search.depth = g->queue_count - search.next;
+        int hold_after = use_hold ? g->current.type : g->hold_piece;
+        search.base_key = zobrist_hold[hold_after + 1] ^ g->seed * 0xbf58476d1ce4e5b9ull;
+
+        for (int r = 0; r < 4; r++)
+        {
+            AiJob *job = &jobs[count++];
+            job->g = g;
+            job->start = start;
+            job->use_hold = use_hold;
+            job->rotation = r;
+            job->search = search;
+        }
+    }
+
+    run_jobs(pool, jobs, count);
+
+    // In fester Reihenfolge auswerten, damit das Ergebnis nicht von der
+    // Anzahl der Threads abhängt
+    int found = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (jobs[i].best.score == INT_MIN)
+            continue;
+        if (!found || jobs[i].best.score > best->score)
+        {
+            *best = jobs[i].best;
+            found = 1;
+        }
+    }
+    return found;
+}
+
+int ai_placement_inputs(const GameState *g, const AiPlacement *p, GameInput *inputs)
+{
+    int n = 0;
+
+    // Wall Kicks können den Stein beim Drehen verschieben
+    Tetromino t = p->use_hold ? hold_start(g) : g->current;
+    rotate_to(g, &t, p->rotation);
+    int x = t.x;
+
+    if (p->use_hold)
+        inputs[n++] = INPUT_HOLD;
+    if (p->rotation == 3)
+    {
+        inputs[n++] = INPUT_ROTATE_CCW;
+    }
+    else
+    {
+        for (int r = 0; r < p->rotation; r++)
+            inputs[n++] = INPUT_ROTATE;
+    }
+    for (; x > p->x; x--)
+        inputs[n++] = INPUT_LEFT;
+    for (; x < p->x; x++)
+        inputs[n++] = INPUT_RIGHT;
+    inputs[n++] = INPUT_HARD_DROP;
+    return n;
+}
@@ -0,0 +1,60 @@
+#ifndef TETRIS_AI_H
+#define TETRIS_AI_H
+
+#include "tetris_core.h"
+
+// Autoplayer: probiert für den aktuellen Stein (und die Hold-Alternative)
+// jede Rotation und jede Spalte per Hard Drop aus und bewertet das Ergebnis.
+// Mit Suchtiefe > 1 zählt für jede Platzierung die beste Folge der nächsten
+// Steine aus der Vorschau (ohne Hold). Bewertete Stellungen landen in einer
+// Transpositionstabelle, die sich alle Threads des Pools teilen.
+
+typedef struct
+{
+    int use_hold; // 1 = zuerst halten, dann den anderen Stein setzen
+    int rotation; // Zielrotation (3 = einmal gegen den Uhrzeigersinn)
+    int x;        // Ziel-x des Tetromino
+    int score;    // Bewertung (höher ist besser)
+} AiPlacement;
+
+// Gewichte der Bewertung
+#define AI_WEIGHT_HEIGHT -510
+#define AI_WEIGHT_LINES 760
+#define AI_WEIGHT_HOLES -357
+#define AI_WEIGHT_BUMPINESS -184
+
+// Suchtiefe in Steinen (1 = nur der aktuelle), höchstens so tief wie die
+// Vorschau reicht
+#define AI_MAX_DEPTH 4
+
+// Transpositionstabelle: 2^AI_TABLE_BITS Einträge zu 16 Byte
+#define AI_TABLE_BITS 18
+
+// Längste Eingabefolge einer Platzierung
+#define AI_MAX_INPUTS (1 + 3 + WIDTH + 1)
+
+typedef struct AiPool AiPool;
+
+// Thread Pool für die Bewertung der Kandidaten mit Suchtiefe depth und
+// eigener Transpositionstabelle; threads <= 1 bewertet im aufrufenden
+// Thread. Ein Pool ohne eigene Threads darf von mehreren Threads
+// gleichzeitig benutzt werden.
+AiPool *ai_pool_create(int threads, int depth);
+void ai_pool_destroy(AiPool *pool);
+
+// Anzahl der Threads, die an einer Suche arbeiten (1 = nur der Aufrufer)
+int ai_pool_threads(const AiPool *pool);
+
+// Bewertet ein Spielfeld nach dem Einrasten (Löcher, Gesamthöhe,
+// Unebenheit, gelöschte Linien)
+int ai_evaluate(const uint16_t rows[HEIGHT], int lines);
+
+// Sucht die beste Platzierung; pool darf NULL sein (Suchtiefe 1, ohne
+// Tabelle). Gibt 0 zurück, wenn es keine gültige Platzierung gibt.
+int ai_find_best(AiPool *pool, const GameState *g, AiPlacement *best);
+
+// Schreibt die Eingaben, die die Platzierung ausführen, nach inputs
+// (mindestens AI_MAX_INPUTS Platz) und gibt ihre Anzahl zurück
+int ai_placement_inputs(const GameState *g, const AiPlacement *p, GameInput *inputs);
+
+#endif
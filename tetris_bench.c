@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ncurses.h>
+#include "tetris_core.h"
+#include "tetris_render_curses.h"
+#include "tetris_render_ansi.h"
+
+// Microbenchmarks für die heißen Pfade des Spielkerns und beide Renderer.
+// Jede Messung läuft in Samples zu je batch Aufrufen (so gewählt, dass ein
+// Sample etwa SAMPLE_NS dauert), bis SAMPLES Samples oder MEASURE_NS Zeit
+// erreicht sind. Ausgegeben wird ns pro Aufruf als Minimum, Perzentile und
+// Mittelwert über die Samples.
+//
+//   ./tetris_bench            alle Messungen
+//   ./tetris_bench clear      nur Messungen, deren Name "clear" enthält
+
+#define SAMPLES 2000
+#define SAMPLE_NS 20000
+#define MEASURE_NS 200000000
+
+// Damit der Compiler Ergebnisse nicht wegoptimiert
+static volatile int sink;
+
+static int64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Spielstände als Eingabe der Messungen
+typedef enum
+{
+    FIXTURE_EMPTY,
+    FIXTURE_HALF,    // Untere Hälfte gefüllt, ein paar Löcher
+    FIXTURE_TOPOUT,  // Bis kurz unter den Rand gefüllt
+    FIXTURE_TETRIS,  // 4 fast volle Zeilen, I-Stein senkrecht über der Lücke
+    FIXTURE_COUNT
+} Fixture;
+
+static const char *fixture_names[FIXTURE_COUNT] = {"leer", "halb", "topout", "4 Linien"};
+
+static void set_cell(GameState *g, int y, int x, int color)
+{
+    g->board_rows[y] |= 1u << x;
+    g->board[y][x] = color;
+}
+
+static void make_fixture(GameState *g, Fixture f)
+{
+    game_init(g, &rules_ncurses, 12345);
+    Rng rng;
+    rng_seed(&rng, 777);
+
+    int top = f == FIXTURE_HALF ? HEIGHT / 2 : f == FIXTURE_TOPOUT ? 3 : HEIGHT;
+    for (int y = top; y < HEIGHT; y++)
+    {
+        // Pro Zeile ein bis zwei Lücken, damit nichts voll ist
+        int gap = rng_below(&rng, WIDTH);
+        int gap2 = rng_below(&rng, WIDTH);
+        for (int x = 0; x < WIDTH; x++)
+        {
+            if (x != gap && x != gap2)
+                set_cell(g, y, x, 1 + rng_below(&rng, 7));
+        }
+    }
+
+    if (f == FIXTURE_TETRIS)
+    {
+        for (int y = HEIGHT - 4; y < HEIGHT; y++)
+        {
+            for (int x = 1; x < WIDTH; x++)
+                set_cell(g, y, x, 1 + (x + y) % 7);
+        }
+        // I senkrecht (Rotation 1 belegt Spalte 2 der 4x4 Box) über Spalte 0
+        g->current = spawn_tetromino(0);
+        g->current.rotation = 1;
+        g->current.x = -2;
+        g->current.y = HEIGHT - 4;
+    }
+    update_derived(g);
+}
+
+// Ein paar Dutzend typische Positionen: alle Spalten und Rotationen des
+// aktuellen Steins in verschiedenen Höhen, manche davon kollidieren
+#define PROBES 64
+static Tetromino probes[PROBES];
+
+static void make_probes()
+{
+    for (int i = 0; i < PROBES; i++)
+    {
+        probes[i].type = i % 7;
+        probes[i].rotation = (i / 7) % 4;
+        probes[i].x = i % (WIDTH - 1) - 1;
+        probes[i].y = (i * 7) % HEIGHT - 1;
+    }
+}
+
+// Ergebnisse einer Messung sammeln und ausgeben
+static double samples[SAMPLES];
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, const char *fixture, int count)
+{
+    qsort(samples, count, sizeof(double), compare_double);
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += samples[i];
+
+    printf("%-22s %-9s %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, fixture,
+           samples[0], samples[count / 2], samples[count * 90 / 100],
+           samples[count * 99 / 100], sum / count);
+    fflush(stdout);
+}
+
+static const char *name_filter = NULL;
+
+static int selected(const char *name)
+{
+    return !name_filter || strstr(name, name_filter);
+}
+
+// Misst body in Samples zu je batch Aufrufen; setup läuft vor jedem Aufruf
+// und wird mitgemessen, dafür gibt es die "kopieren" Messung als Basis
+#define MEASURE(name, fixture, setup, body)                                  \
+    do                                                                       \
+    {                                                                        \
+        if (!selected(name))                                                 \
+            break;                                                           \
+        int batch = 1;                                                       \
+        int count = 0;                                                       \
+        int64_t begin = now_ns();                                            \
+        while (count < SAMPLES && now_ns() - begin < MEASURE_NS)             \
+        {                                                                    \
+            int64_t start = now_ns();                                        \
+            for (int b = 0; b < batch; b++)                                  \
+            {                                                                \
+                setup;                                                       \
+                body;                                                        \
+            }                                                                \
+            int64_t elapsed = now_ns() - start;                              \
+            /* Anfangs batch hochfahren, diese Samples zählen nicht */       \
+            if (elapsed < SAMPLE_NS / 2 && count == 0)                       \
+            {                                                                \
+                batch *= 2;                                                  \
+                continue;                                                    \
+            }                                                                \
+            samples[count++] = (double)elapsed / batch;                      \
+        }                                                                    \
+        report(name, fixture, count);                                        \
+    } while (0)
+
+static void bench_core()
+{
+    make_probes();
+
+    for (int f = 0; f < FIXTURE_COUNT; f++)
+    {
+        GameState base, g;
+        make_fixture(&base, f);
+        g = base;
+
+        MEASURE("check_collision", fixture_names[f], (void)0,
+                sink += check_collision(&base, &probes[b % PROBES]));
+
+        MEASURE("kopieren (Basis)", fixture_names[f], memcpy(&g, &base, sizeof(g)), sink += g.score);
+
+        MEASURE("drop_distance", fixture_names[f], (void)0, sink += drop_distance(&base, &base.current));
+
+        // Stein an seine Landeposition bringen, dort einrasten
+        Tetromino landed = base.current;
+        landed.y += drop_distance(&base, &landed);
+
+        MEASURE("merge_tetromino", fixture_names[f], memcpy(&g, &base, sizeof(g)),
+                merge_tetromino(&g, &landed));
+
+        GameState merged = base;
+        merge_tetromino(&merged, &landed);
+        uint64_t cleared;
+        MEASURE("clear_lines", fixture_names[f], memcpy(&g, &merged, sizeof(g)),
+                sink += clear_lines(&g, &cleared));
+
+        MEASURE("get_next_piece", fixture_names[f], (void)0, sink += get_next_piece(&g));
+
+        // Tiefe Vorschau wie für Bots: kostet pro Stein dasselbe
+        game_set_lookahead(&g, MAX_LOOKAHEAD);
+        MEASURE("get_next_piece tief", fixture_names[f], (void)0, sink += get_next_piece(&g));
+        MEASURE("peek_piece tief", fixture_names[f], (void)0, sink += peek_piece(&g, b % MAX_LOOKAHEAD));
+    }
+
+    // Drehen auf leerem Feld: T frei in der Mitte (erste Lage passt) und
+    // senkrecht an der linken Wand, wo erst der zweite Kick passt
+    GameState empty;
+    make_fixture(&empty, FIXTURE_EMPTY);
+    Tetromino free_t = spawn_tetromino(2), wall_t = spawn_tetromino(2), t;
+    free_t.y = wall_t.y = HEIGHT / 2;
+    wall_t.rotation = 1;
+    wall_t.x = -1;
+    MEASURE("rotate_tetromino", "leer", t = free_t, sink += rotate_tetromino(&empty, &t, 1));
+    MEASURE("rotate_tetromino Kick", "leer", t = wall_t, sink += rotate_tetromino(&empty, &t, 1) + t.x);
+}
+
+// Zwei abwechselnde Spielstände: Stein eine Spalte weiter, wie bei einem
+// Tastendruck. "voll" zeichnet jedes Mal alles neu.
+static void bench_draw()
+{
+    int null_fd = open("/dev/null", O_WRONLY);
+    FILE *null_out = fdopen(null_fd, "w");
+    FILE *null_in = fopen("/dev/null", "r");
+    if (!null_out || !null_in)
+    {
+        fprintf(stderr, "/dev/null nicht verfügbar\n");
+        return;
+    }
+
+    for (int f = 0; f < FIXTURE_COUNT; f++)
+    {
+        GameState frames[2];
+        make_fixture(&frames[0], f);
+        frames[1] = frames[0];
+        frames[1].current.x++;
+        if (check_collision(&frames[1], &frames[1].current))
+            frames[1].current.x -= 2;
+
+        ansi_set_output(null_fd);
+        MEASURE("ansi draw_board", fixture_names[f], (void)0, ansi_draw_board(&frames[b & 1]));
+        MEASURE("ansi draw_board voll", fixture_names[f], ansi_invalidate(), ansi_draw_board(&frames[b & 1]));
+
+        if (!selected("curses draw_board"))
+            continue;
+
+        SCREEN *screen = newterm("xterm-256color", null_out, null_in);
+        if (!screen)
+        {
+            fprintf(stderr, "ncurses: Terminal xterm-256color nicht gefunden\n");
+            continue;
+        }
+        curses_init_colors();
+        curses_invalidate();
+
+        MEASURE("curses draw_board", fixture_names[f], (void)0, curses_draw_board(&frames[b & 1]));
+        MEASURE("curses draw_board voll", fixture_names[f], curses_invalidate(), curses_draw_board(&frames[b & 1]));
+
+        endwin();
+        delscreen(screen);
+    }
+
+    fclose(null_in);
+    fclose(null_out);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        name_filter = argv[1];
+
+    printf("sizeof(GameState) = %zu Byte\n\n", sizeof(GameState));
+    printf("%-22s %-9s %9s %9s %9s %9s %9s\n", "ns/op", "Spielfeld", "min", "p50", "p90", "p99", "Mittel");
+    bench_core();
+    bench_draw();
+    return 0;
+}
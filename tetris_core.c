@@ -0,0 +1,705 @@
+#include <string.h>
+#include "tetris_core.h"
+
+// Tetromino Formen (7 verschiedene) in Ausgangslage nach SRS. I dreht in
+// der 4x4 Box, das O gar nicht, die übrigen in der 3x3 Box oben links.
+int shapes[7][4][4] = {
+    // I
+    {{0, 0, 0, 0},
+     {1, 1, 1, 1},
+     {0, 0, 0, 0},
+     {0, 0, 0, 0}},
+    // O
+    {{0, 1, 1, 0},
+     {0, 1, 1, 0},
+     {0, 0, 0, 0},
+     {0, 0, 0, 0}},
+    // T
+    {{0, 1, 0, 0},
+     {1, 1, 1, 0},
+     {0, 0, 0, 0},
+     {0, 0, 0, 0}},
+    // S
+    {{0, 1, 1, 0},
+     {1, 1, 0, 0},
+     {0, 0, 0, 0},
+     {0, 0, 0, 0}},
+    // Z
+    {{1, 1, 0, 0},
+     {0, 1, 1, 0},
+     {0, 0, 0, 0},
+     {0, 0, 0, 0}},
+    // J
+    {{1, 0, 0, 0},
+     {1, 1, 1, 0},
+     {0, 0, 0, 0},
+     {0, 0, 0, 0}},
+    // L
+    {{0, 0, 1, 0},
+     {1, 1, 1, 0},
+     {0, 0, 0, 0},
+     {0, 0, 0, 0}}};
+
+// SRS Wall Kicks: für jede Ausgangsrotation (0, R, 2, L) und Richtung
+// (0 = im Uhrzeigersinn, 1 = dagegen) bis zu 5 Verschiebungen {dx, dy},
+// die der Reihe nach probiert werden. dy zählt wie y nach unten. Das O
+// dreht ohne Kicks.
+const int8_t srs_kicks[2][4][2][SRS_KICKS][2] = {
+    // J, L, S, T, Z
+    {{{{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}},  // 0 -> R
+      {{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}},    // 0 -> L
+     {{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}},    // R -> 2
+      {{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},   // R -> 0
+     {{{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}},     // 2 -> L
+      {{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}}, // 2 -> R
+     {{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}, // L -> 0
+      {{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}}}, // L -> 2
+    // I
+    {{{{0, 0}, {-2, 0}, {1, 0}, {-2, 1}, {1, -2}},  // 0 -> R
+      {{0, 0}, {-1, 0}, {2, 0}, {-1, -2}, {2, 1}}}, // 0 -> L
+     {{{0, 0}, {-1, 0}, {2, 0}, {-1, -2}, {2, 1}},  // R -> 2
+      {{0, 0}, {2, 0}, {-1, 0}, {2, -1}, {-1, 2}}}, // R -> 0
+     {{{0, 0}, {2, 0}, {-1, 0}, {2, -1}, {-1, 2}},  // 2 -> L
+      {{0, 0}, {1, 0}, {-2, 0}, {1, 2}, {-2, -1}}}, // 2 -> R
+     {{{0, 0}, {1, 0}, {-2, 0}, {1, 2}, {-2, -1}},  // L -> 0
+      {{0, 0}, {-2, 0}, {1, 0}, {-2, 1}, {1, -2}}}}}; // L -> 2
+
+PieceRotation piece_table[7][4];
+static int piece_table_ready = 0;
+
+uint64_t zobrist_cells[HEIGHT][WIDTH];
+uint64_t zobrist_hold[8];
+
+// ncurses Version: Level up alle 5 Linien, 50ms schneller pro Level
+const GameRules rules_ncurses = {500, 50, 50, 5};
+// ANSI Version: Level up alle 10 Linien, 25ms schneller pro Level
+const GameRules rules_ansi = {300, 25, 80, 10};
+
+// Im Uhrzeigersinn innerhalb der Box size x size oben links drehen
+static void rotate_in_box(int shape[4][4], int rotated[4][4], int size)
+{
+    memset(rotated, 0, 16 * sizeof(int));
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            rotated[i][j] = shape[size - 1 - j][i];
+        }
+    }
+}
+
+// Füllt piece_table einmal; danach muss keine Form mehr kopiert oder
+// rotiert werden. Vor dem Start von Threads aufrufen.
+void init_piece_table()
+{
+    if (piece_table_ready)
+        return;
+
+    for (int type = 0; type < 7; type++)
+    {
+        int current_shape[4][4];
+        memcpy(current_shape, shapes[type], sizeof(current_shape));
+
+        for (int r = 0; r < 4; r++)
+        {
+            PieceRotation *p = &piece_table[type][r];
+            int n = 0;
+            p->min_x = p->min_y = 3;
+            p->max_x = p->max_y = 0;
+
+            for (int i = 0; i < 4; i++)
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    if (current_shape[i][j])
+                    {
+                        p->cells[n][0] = i;
+                        p->cells[n][1] = j;
+                        n++;
+                        if (j < p->min_x)
+                            p->min_x = j;
+                        if (j > p->max_x)
+                            p->max_x = j;
+                        if (i < p->min_y)
+                            p->min_y = i;
+                        if (i > p->max_y)
+                            p->max_y = i;
+                    }
+                }
+            }
+
+            for (int i = 0; i < 4; i++)
+            {
+                p->row_masks[i] = 0;
+            }
+            for (int k = 0; k < 4; k++)
+            {
+                p->row_masks[p->cells[k][0]] |= 1u << (p->cells[k][1] - p->min_x);
+            }
+
+            for (int j = 0; j < 4; j++)
+            {
+                p->bottom[j] = -1;
+            }
+            for (int k = 0; k < 4; k++)
+            {
+                if (p->cells[k][0] > p->bottom[p->cells[k][1]])
+                    p->bottom[p->cells[k][1]] = p->cells[k][0];
+            }
+
+            // Nächste Rotation vorbereiten; das O sieht in jeder Rotation
+            // gleich aus
+            if (type != 1)
+            {
+                int temp[4][4];
+                rotate_in_box(current_shape, temp, type == 0 ? 4 : 3);
+                memcpy(current_shape, temp, sizeof(current_shape));
+            }
+        }
+    }
+
+    // Zobrist Schlüssel, immer dieselben, damit Hashes reproduzierbar sind
+    Rng rng;
+    rng_seed(&rng, 0x5a0b815ull);
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            zobrist_cells[y][x] = (uint64_t)rng_next(&rng) << 32 | rng_next(&rng);
+        }
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        zobrist_hold[i] = (uint64_t)rng_next(&rng) << 32 | rng_next(&rng);
+    }
+
+    piece_table_ready = 1;
+}
+
+void rng_seed(Rng *r, uint64_t seed)
+{
+    r->state = 0;
+    r->inc = (seed << 1) | 1;
+    rng_next(r);
+    r->state += seed;
+    rng_next(r);
+}
+
+uint32_t rng_next(Rng *r)
+{
+    uint64_t old = r->state;
+    r->state = old * 6364136223846793005ULL + r->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+uint32_t rng_below(Rng *r, uint32_t bound)
+{
+    // Werte unterhalb von threshold verwerfen, sonst wären kleine Zahlen
+    // leicht bevorzugt
+    uint32_t threshold = (uint32_t)(0u - bound) % bound;
+    while (1)
+    {
+        uint32_t value = rng_next(r);
+        if (value >= threshold)
+            return value % bound;
+    }
+}
+
+// Einen gemischten Bag mit allen 7 Steinen hinten an die Warteschlange
+static void push_bag(GameState *g)
+{
+    uint8_t bag[7];
+    for (int i = 0; i < 7; i++)
+    {
+        bag[i] = i;
+    }
+
+    // Fisher-Yates Shuffle
+    for (int i = 6; i > 0; i--)
+    {
+        int j = rng_below(&g->rng, i + 1);
+        uint8_t temp = bag[i];
+        bag[i] = bag[j];
+        bag[j] = temp;
+    }
+
+    uint32_t tail = g->queue_head + g->queue_count;
+    for (int i = 0; i < 7; i++)
+    {
+        g->queue[(tail + i) & (PIECE_QUEUE_SIZE - 1)] = bag[i];
+    }
+    g->queue_count += 7;
+}
+
+void game_set_lookahead(GameState *g, int n)
+{
+    if (n < 1)
+        n = 1;
+    if (n > MAX_LOOKAHEAD)
+        n = MAX_LOOKAHEAD;
+    g->lookahead = n;
+    while (g->queue_count < g->lookahead)
+        push_bag(g);
+}
+
+int get_next_piece(GameState *g)
+{
+    int piece = g->queue[g->queue_head & (PIECE_QUEUE_SIZE - 1)];
+    g->queue_head++;
+    g->queue_count--;
+    if (g->queue_count < g->lookahead)
+        push_bag(g);
+    return piece;
+}
+
+// Stein eines Typs in Startposition oben in der Mitte, oberste Zeile des
+// Steins in Zeile 0
+Tetromino spawn_tetromino(int type)
+{
+    Tetromino t;
+    t.type = type;
+    t.x = WIDTH / 2 - 2;
+    t.y = -piece_table[type][0].min_y;
+    t.rotation = 0;
+    return t;
+}
+
+Tetromino create_tetromino(GameState *g)
+{
+    return spawn_tetromino(get_next_piece(g)); // Benutze Next-System
+}
+
+void game_init(GameState *g, const GameRules *rules, uint64_t seed)
+{
+    init_piece_table();
+
+    memset(g, 0, sizeof(*g));
+    g->rules = *rules;
+    g->level = 1;
+    g->fall_speed = rules->start_speed;
+    g->hold_piece = -1;
+    g->can_hold = 1;
+    g->seed = seed;
+    rng_seed(&g->rng, seed);
+    game_set_lookahead(g, NEXT_PIECES);
+
+    g->current = create_tetromino(g);
+}
+
+int check_collision(const GameState *g, const Tetromino *t)
+{
+    return rows_collide(g->board_rows, t);
+}
+
+int rows_collide(const uint16_t rows[HEIGHT], const Tetromino *t)
+{
+    const PieceRotation *p = &piece_table[t->type][t->rotation % 4];
+
+    // Bounding Box gegen Wände und Boden prüfen
+    if (t->x + p->min_x < 0 || t->x + p->max_x >= WIDTH || t->y + p->max_y >= HEIGHT)
+        return 1;
+
+    // Pro Zeile eine Verschiebung und ein AND
+    int shift = t->x + p->min_x;
+    for (int i = p->min_y; i <= p->max_y; i++)
+    {
+        int y = t->y + i;
+        if (y >= 0 && (rows[y] & (p->row_masks[i] << shift)))
+            return 1;
+    }
+    return 0;
+}
+
+void rows_merge(uint16_t rows[HEIGHT], const Tetromino *t)
+{
+    const PieceRotation *p = &piece_table[t->type][t->rotation % 4];
+    int shift = t->x + p->min_x;
+
+    for (int i = p->min_y; i <= p->max_y; i++)
+    {
+        int y = t->y + i;
+        if (y >= 0)
+            rows[y] |= p->row_masks[i] << shift;
+    }
+}
+
+// Entfernt alle vollen Zeilen in einem Durchlauf von unten nach oben: jede
+// verbleibende Zeile wird höchstens einmal an ihre neue Position kopiert.
+uint64_t rows_clear(uint16_t rows[HEIGHT])
+{
+    uint64_t mask = 0;
+    int write = HEIGHT - 1;
+
+    for (int read = HEIGHT - 1; read >= 0; read--)
+    {
+        if (rows[read] == FULL_ROW)
+        {
+            mask |= (uint64_t)1 << read;
+            continue;
+        }
+        rows[write--] = rows[read];
+    }
+
+    // Oben nachrückende Zeilen sind leer
+    for (int y = 0; y <= write; y++)
+        rows[y] = 0;
+    return mask;
+}
+
+void rows_heights(const uint16_t rows[HEIGHT], uint8_t heights[WIDTH])
+{
+    memset(heights, 0, WIDTH);
+    uint16_t seen = 0;
+    for (int y = 0; y < HEIGHT && seen != FULL_ROW; y++)
+    {
+        uint16_t fresh = rows[y] & ~seen;
+        for (int x = 0; fresh; x++, fresh >>= 1)
+        {
+            if (fresh & 1)
+                heights[x] = HEIGHT - y;
+        }
+        seen |= rows[y];
+    }
+}
+
+int rows_drop_distance(const uint16_t rows[HEIGHT], const uint8_t heights[WIDTH], const Tetromino *t)
+{
+    const PieceRotation *p = &piece_table[t->type][t->rotation % 4];
+    int distance = HEIGHT;
+
+    for (int j = p->min_x; j <= p->max_x; j++)
+    {
+        int bottom = t->y + p->bottom[j];
+        int top = HEIGHT - heights[t->x + j]; // Erste belegte Zeile oder HEIGHT
+        if (bottom >= top)
+        {
+            // Unter einem Überhang: Zeile für Zeile
+            Tetromino temp = *t;
+            do
+                temp.y++;
+            while (!rows_collide(rows, &temp));
+            return temp.y - 1 - t->y;
+        }
+        if (top - 1 - bottom < distance)
+            distance = top - 1 - bottom;
+    }
+    return distance;
+}
+
+void merge_tetromino(GameState *g, const Tetromino *t)
+{
+    const PieceRotation *p = &piece_table[t->type][t->rotation % 4];
+
+    rows_merge(g->board_rows, t);
+    for (int k = 0; k < 4; k++)
+    {
+        int y = t->y + p->cells[k][0];
+        int x = t->x + p->cells[k][1];
+        if (y >= 0 && y < HEIGHT && x >= 0 && x < WIDTH)
+        {
+            g->board[y][x] = t->type + 1;
+            g->board_hash ^= zobrist_cells[y][x];
+            if (HEIGHT - y > g->heights[x])
+                g->heights[x] = HEIGHT - y;
+        }
+    }
+}
+
+// XOR der Zellschlüssel einer Zeile y mit Belegung row
+static uint64_t zobrist_row(int y, uint16_t row)
+{
+    uint64_t hash = 0;
+    for (int x = 0; row; x++, row >>= 1)
+    {
+        if (row & 1)
+            hash ^= zobrist_cells[y][x];
+    }
+    return hash;
+}
+
+uint64_t zobrist_rows(const uint16_t rows[HEIGHT])
+{
+    uint64_t hash = 0;
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        if (rows[y])
+            hash ^= zobrist_row(y, rows[y]);
+    }
+    return hash;
+}
+
+void update_derived(GameState *g)
+{
+    g->board_hash = zobrist_rows(g->board_rows);
+    rows_heights(g->board_rows, g->heights);
+}
+
+// Höhen nach dem Löschen der Zeilen in mask: jede gelöschte Zeile unter
+// der Spitze einer Spalte senkt sie um eins. Nur wenn die Spitze selbst
+// gelöscht wurde, kann darunter ein Loch liegen; dann wird ab der neuen
+// Höchstgrenze nach unten gesucht.
+static void heights_after_clear(GameState *g, uint64_t mask)
+{
+    for (int x = 0; x < WIDTH; x++)
+    {
+        int top = HEIGHT - g->heights[x];
+        if (top >= HEIGHT)
+            continue;
+
+        uint64_t below = mask >> top; // Bit 0 = Zeile top
+        int h = g->heights[x] - __builtin_popcountll(below);
+        if (below & 1)
+        {
+            int y = HEIGHT - h;
+            while (y < HEIGHT && !(g->board_rows[y] & (1u << x)))
+                y++;
+            h = HEIGHT - y;
+        }
+        g->heights[x] = h;
+    }
+}
+
+// Entfernt alle vollen Zeilen mit rows_clear und zieht die Farben mit.
+// Gibt die Anzahl zurück; in cleared_rows (darf NULL sein) landet Bit i für
+// jede gelöschte Zeile i (Index vor dem Löschen).
+int clear_lines(GameState *g, uint64_t *cleared_rows)
+{
+    uint64_t mask = rows_clear(g->board_rows);
+    int cleared = __builtin_popcountll(mask);
+
+    if (cleared > 0)
+    {
+        int write = HEIGHT - 1;
+        for (int read = HEIGHT - 1; read >= 0; read--)
+        {
+            if (mask & ((uint64_t)1 << read))
+                continue;
+            if (write != read)
+                memcpy(g->board[write], g->board[read], sizeof(g->board[write]));
+            write--;
+        }
+        memset(g->board, 0, cleared * sizeof(g->board[0]));
+
+        // Fast jede Zeile ist umgezogen: neu rechnen statt umschlüsseln
+        g->board_hash = zobrist_rows(g->board_rows);
+        heights_after_clear(g, mask);
+    }
+
+    if (cleared_rows)
+        *cleared_rows = mask;
+    return cleared;
+}
+
+int drop_distance(const GameState *g, const Tetromino *t)
+{
+    return rows_drop_distance(g->board_rows, g->heights, t);
+}
+
+// Zellen eines Steins in display eintragen (soweit im Spielfeld)
+static void display_piece(int display[HEIGHT][WIDTH], const Tetromino *t, int y0, int value)
+{
+    const PieceRotation *p = &piece_table[t->type][t->rotation % 4];
+    for (int k = 0; k < 4; k++)
+    {
+        int y = y0 + p->cells[k][0];
+        int x = t->x + p->cells[k][1];
+        if (y >= 0 && y < HEIGHT && x >= 0 && x < WIDTH)
+            display[y][x] = value;
+    }
+}
+
+void game_display(const GameState *g, int display[HEIGHT][WIDTH])
+{
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        for (int j = 0; j < WIDTH; j++)
+        {
+            display[i][j] = g->board[i][j];
+        }
+    }
+
+    if (g->game_over)
+        return;
+
+    const Tetromino *current = &g->current;
+    display_piece(display, current, current->y + drop_distance(g, current), GHOST_CELL + current->type);
+    display_piece(display, current, current->y, current->type + 1);
+}
+
+// Stein einrasten, Linien löschen, Punkte zählen und nächsten Stein holen
+static int lock_piece(GameState *g)
+{
+    int events = GAME_EVENT_LOCKED;
+
+    if (g->probe)
+        g->probe(g->probe_ctx, GAME_PROBE_MERGE, 1);
+    merge_tetromino(g, &g->current);
+    g->pieces++;
+    if (g->probe)
+    {
+        g->probe(g->probe_ctx, GAME_PROBE_MERGE, 0);
+        g->probe(g->probe_ctx, GAME_PROBE_CLEAR, 1);
+    }
+
+    int cleared = clear_lines(g, &g->last_cleared_rows);
+    if (g->probe)
+        g->probe(g->probe_ctx, GAME_PROBE_CLEAR, 0);
+    if (cleared > 0)
+    {
+        events |= GAME_EVENT_LINES;
+        g->lines_cleared += cleared;
+        g->score += cleared * cleared * 100;
+        g->level = 1 + g->lines_cleared / g->rules.lines_per_level;
+        g->fall_speed = g->rules.start_speed - (g->level - 1) * g->rules.speed_step;
+        if (g->fall_speed < g->rules.min_speed)
+            g->fall_speed = g->rules.min_speed;
+    }
+
+    g->current = create_tetromino(g);
+    g->can_hold = 1; // Neuer Stein, kann wieder gehalten werden
+
+    if (check_collision(g, &g->current))
+    {
+        g->game_over = 1;
+        events |= GAME_EVENT_OVER;
+    }
+    return events;
+}
+
+int rotate_tetromino(const GameState *g, Tetromino *t, int dir)
+{
+    int from = t->rotation & 3;
+    Tetromino temp = *t;
+    temp.rotation = (from + (dir > 0 ? 1 : 3)) & 3;
+
+    if (t->type == 1)
+    {
+        // O: alle Rotationen belegen dieselben Zellen
+        *t = temp;
+        return 1;
+    }
+
+    const int8_t(*kicks)[2] = srs_kicks[t->type == 0][from][dir < 0];
+    for (int k = 0; k < SRS_KICKS; k++)
+    {
+        temp.x = t->x + kicks[k][0];
+        temp.y = t->y + kicks[k][1];
+        if (!check_collision(g, &temp))
+        {
+            *t = temp;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Stein um dx/dy verschieben, falls Platz ist
+static int try_move(GameState *g, int dx, int dy)
+{
+    Tetromino temp = g->current;
+    temp.x += dx;
+    temp.y += dy;
+    if (check_collision(g, &temp))
+        return 0;
+    g->current = temp;
+    return GAME_EVENT_MOVED;
+}
+
+static int try_rotate(GameState *g, int dir)
+{
+    return rotate_tetromino(g, &g->current, dir) ? GAME_EVENT_MOVED : 0;
+}
+
+static int hard_drop(GameState *g)
+{
+    // Stein fällt sofort runter
+    g->current.y += drop_distance(g, &g->current);
+    g->fall_timer = 0; // Timer zurücksetzen
+    return lock_piece(g);
+}
+
+static int hold(GameState *g)
+{
+    // Kann nur einmal pro Stein benutzt werden
+    if (!g->can_hold)
+        return 0;
+
+    if (g->hold_piece == -1)
+    {
+        // Erstes Mal halten - speichere aktuellen Stein
+        g->hold_piece = g->current.type;
+        g->current = create_tetromino(g);
+    }
+    else
+    {
+        // Tausche mit gehaltenem Stein
+        int temp_type = g->current.type;
+        g->current = spawn_tetromino(g->hold_piece);
+        g->hold_piece = temp_type;
+    }
+    g->can_hold = 0;
+
+    // Prüfe ob der neue Stein passt, wenn nicht: Game Over
+    if (check_collision(g, &g->current))
+    {
+        g->game_over = 1;
+        return GAME_EVENT_HOLD | GAME_EVENT_OVER;
+    }
+    return GAME_EVENT_HOLD | GAME_EVENT_MOVED;
+}
+
+static int apply_input(GameState *g, GameInput input)
+{
+    switch (input)
+    {
+    case INPUT_LEFT:
+        return try_move(g, -1, 0);
+    case INPUT_RIGHT:
+        return try_move(g, 1, 0);
+    case INPUT_SOFT_DROP:
+        return try_move(g, 0, 1);
+    case INPUT_ROTATE:
+        return try_rotate(g, 1);
+    case INPUT_ROTATE_CCW:
+        return try_rotate(g, -1);
+    case INPUT_HARD_DROP:
+        return hard_drop(g);
+    case INPUT_HOLD:
+        return hold(g);
+    case INPUT_QUIT:
+        g->game_over = 1;
+        return GAME_EVENT_OVER;
+    default:
+        return 0;
+    }
+}
+
+int game_step(GameState *g, GameInput input, int dt)
+{
+    if (g->game_over)
+        return 0;
+
+    int events = apply_input(g, input);
+    if (g->game_over)
+        return events; // Die Zeit bleibt beim Ende stehen
+
+    // Schwerkraft: Rest über fall_speed hinaus bleibt erhalten, dadurch ist
+    // das Ergebnis unabhängig davon, wie dt aufgeteilt wird
+    g->fall_timer += dt;
+    while (!g->game_over && g->fall_timer >= g->fall_speed)
+    {
+        g->fall_timer -= g->fall_speed;
+        int moved = try_move(g, 0, 1);
+        events |= moved ? moved : lock_piece(g);
+    }
+
+    // Endet das Spiel unterwegs, zählt die Zeit nur bis zu dem Fall-Schritt,
+    // der es beendet hat (fall_timer ist der Rest danach)
+    if (g->game_over && g->fall_timer < dt)
+        g->time_ms += dt - g->fall_timer;
+    else if (!g->game_over)
+        g->time_ms += dt;
+    return events;
+}
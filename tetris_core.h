@@ -0,0 +1,233 @@
+#ifndef TETRIS_CORE_H
+#define TETRIS_CORE_H
+
+#include <stdint.h>
+
+// Spielkern ohne Terminal-Ein/Ausgabe. Der komplette Zustand eines Spiels
+// steckt in GameState, damit beliebig viele Spiele nebeneinander laufen
+// können (Simulation, Lasttests, mehrere Threads).
+
+// Spielfeld Dimensionen
+#define WIDTH 10
+#define HEIGHT 20
+#define NEXT_PIECES 4 // Vorschau in den Frontends, Standard für lookahead
+
+// Warteschlange der kommenden Steine als Ring (Zweierpotenz); wird in
+// ganzen Bags nachgefüllt, daher höchstens PIECE_QUEUE_SIZE - 7 Vorschau.
+// Der Ring liegt im GameState, damit jede Kopie (Render-Frames, Replay-
+// Keyframes, Perft) ein eigenständiger Spielstand bleibt. Er macht den
+// GameState 1432 statt 432 Byte groß; gemessen kostet das etwa 14 ns pro
+// Kopie und 3-5% Knoten/s bei tetris_perft.
+#define PIECE_QUEUE_SIZE 1024
+#define MAX_LOOKAHEAD (PIECE_QUEUE_SIZE - 7)
+
+#if WIDTH > 16
+#error "board_rows braucht WIDTH <= 16"
+#endif
+#if HEIGHT > 64
+#error "clear_lines liefert die gelöschten Zeilen als 64-Bit Maske"
+#endif
+#define FULL_ROW ((1u << WIDTH) - 1)
+
+typedef struct
+{
+    int x, y;
+    int type;
+    int rotation;
+} Tetromino;
+
+// Vorberechnete Rotationen: für jeden Typ und jede Rotation die 4 Zellen
+// (relativ zur 4x4 Box) und die Bounding Box
+typedef struct
+{
+    int cells[4][2];       // {Zeile, Spalte}
+    uint16_t row_masks[4]; // Zeilenmasken, Bit 0 = Spalte min_x
+    int8_t bottom[4];      // Unterste Zeile pro Spalte der Box, -1 = leer
+    int min_x, max_x;
+    int min_y, max_y;
+} PieceRotation;
+
+extern int shapes[7][4][4];
+extern PieceRotation piece_table[7][4];
+
+// SRS Wall Kicks: [I ja/nein][Ausgangsrotation][0 = im Uhrzeigersinn,
+// 1 = dagegen][Versuch] = {dx, dy}
+#define SRS_KICKS 5
+extern const int8_t srs_kicks[2][4][2][SRS_KICKS][2];
+
+// Zobrist Schlüssel: einer pro Zelle und einer pro Hold-Zustand (kein Stein
+// und die 7 Typen). Fest aus einem Seed erzeugt von init_piece_table.
+extern uint64_t zobrist_cells[HEIGHT][WIDTH];
+extern uint64_t zobrist_hold[8];
+
+// Zufallsgenerator pro Spiel (PCG32), damit Spiele unabhängig voneinander
+// und in mehreren Threads laufen können
+typedef struct
+{
+    uint64_t state;
+    uint64_t inc;
+} Rng;
+
+void rng_seed(Rng *r, uint64_t seed);
+uint32_t rng_next(Rng *r);
+uint32_t rng_below(Rng *r, uint32_t bound); // Gleichverteilt in [0, bound)
+
+// Regeln, in denen sich die Frontends unterscheiden (Zeiten in ms)
+typedef struct
+{
+    int start_speed;     // Fall-Geschwindigkeit in Level 1
+    int speed_step;      // Pro Level so viel schneller
+    int min_speed;       // Schnellste Fall-Geschwindigkeit
+    int lines_per_level; // Level up alle n Linien
+} GameRules;
+
+extern const GameRules rules_ncurses;
+extern const GameRules rules_ansi;
+
+typedef enum
+{
+    INPUT_NONE,
+    INPUT_LEFT,
+    INPUT_RIGHT,
+    INPUT_SOFT_DROP,
+    INPUT_HARD_DROP,
+    INPUT_ROTATE,
+    INPUT_HOLD,
+    INPUT_QUIT,
+    INPUT_ROTATE_CCW
+} GameInput;
+
+// Rückgabe von game_step: was sich geändert hat
+#define GAME_EVENT_MOVED 1  // Aktueller Stein hat sich bewegt
+#define GAME_EVENT_LOCKED 2 // Stein eingerastet, neuer Stein da
+#define GAME_EVENT_LINES 4  // Linien gelöscht
+#define GAME_EVENT_HOLD 8   // Hold benutzt
+#define GAME_EVENT_OVER 16  // Spiel zu Ende
+
+// Messpunkte im Spielkern für Statistik und Trace. Der Kern kennt keine Uhr,
+// er meldet nur Anfang (begin = 1) und Ende (begin = 0) einer Phase.
+typedef enum
+{
+    GAME_PROBE_MERGE, // merge_tetromino beim Einrasten
+    GAME_PROBE_CLEAR  // clear_lines beim Einrasten
+} GameProbePoint;
+
+typedef void (*GameProbe)(void *ctx, GameProbePoint point, int begin);
+
+typedef struct
+{
+    // Belegung als Bitmaske pro Zeile (Bit j = Spalte j) für Kollision und
+    // volle Zeilen; board enthält die Farben (Typ + 1) nur für die Renderer
+    uint16_t board_rows[HEIGHT];
+    uint8_t board[HEIGHT][WIDTH];
+
+    // Höhe pro Spalte (HEIGHT - oberste belegte Zeile, 0 = leer) und XOR
+    // der zobrist_cells aller belegten Zellen, werden von merge_tetromino
+    // und clear_lines mitgeführt
+    uint8_t heights[WIDTH];
+    uint64_t board_hash;
+
+    Tetromino current;
+
+    // Hold und Next Steine
+    int hold_piece; // -1 = kein Stein gespeichert
+    int can_hold;   // Kann nur einmal pro Stein gehalten werden
+
+    // Kommende Steine: queue[(queue_head + n) % PIECE_QUEUE_SIZE] ist der
+    // n-te. Es liegen immer mindestens lookahead Steine bereit, nachgefüllt
+    // wird mit je einem gemischten Bag aller 7 Steine.
+    uint8_t queue[PIECE_QUEUE_SIZE];
+    uint32_t queue_head;
+    int queue_count;
+    int lookahead;
+    Rng rng;
+    uint64_t seed; // Gleicher Seed + gleiche Eingaben = gleiches Spiel
+
+    int score;
+    int level;
+    int lines_cleared;
+    int game_over;
+    int pieces; // Bisher eingerastete Steine
+
+    // Schwerkraft in Simulationszeit (ms)
+    int fall_speed;
+    int fall_timer; // Seit dem letzten Fall-Schritt vergangen
+    int64_t time_ms; // Insgesamt simulierte Zeit, bleibt bei game_over stehen
+
+    uint64_t last_cleared_rows; // Maske der zuletzt gelöschten Zeilen
+
+    GameRules rules;
+
+    GameProbe probe; // NULL = keine Messung
+    void *probe_ctx;
+} GameState;
+
+void init_piece_table();
+
+void game_init(GameState *g, const GameRules *rules, uint64_t seed);
+
+int check_collision(const GameState *g, const Tetromino *t);
+
+// check_collision auf nackten Zeilenmasken, z.B. für Suchbäume
+int rows_collide(const uint16_t rows[HEIGHT], const Tetromino *t);
+// Stein in rows setzen; Zellen über dem Spielfeld fallen weg
+void rows_merge(uint16_t rows[HEIGHT], const Tetromino *t);
+// Volle Zeilen entfernen; Bit i der Rückgabe = gelöschte Zeile i (Index vor dem Löschen)
+uint64_t rows_clear(uint16_t rows[HEIGHT]);
+// Höhe pro Spalte wie GameState.heights
+void rows_heights(const uint16_t rows[HEIGHT], uint8_t heights[WIDTH]);
+// drop_distance auf nackten Zeilen mit ihren Spaltenhöhen
+int rows_drop_distance(const uint16_t rows[HEIGHT], const uint8_t heights[WIDTH], const Tetromino *t);
+void merge_tetromino(GameState *g, const Tetromino *t);
+int clear_lines(GameState *g, uint64_t *cleared_rows);
+
+// heights und board_hash aus board_rows neu berechnen, für Code, der
+// board_rows direkt beschreibt
+void update_derived(GameState *g);
+
+// Zobrist Hash beliebiger Zeilenmasken (wie board_hash)
+uint64_t zobrist_rows(const uint16_t rows[HEIGHT]);
+
+// Schlüssel für die Position in der Steinfolge (queue_head + n)
+static inline uint64_t zobrist_queue(uint32_t position)
+{
+    return (position + 1) * 0x9e3779b97f4a7c15ull;
+}
+
+// Wie viele Zeilen t (darf nicht kollidieren) fallen kann, bis er aufliegt.
+// Liegt t über allen Spalten, in denen er steckt, reichen heights und das
+// Profil der Rotation; nur unter Überhängen wird Zeile für Zeile geprüft.
+int drop_distance(const GameState *g, const Tetromino *t);
+
+// Zellwert für den Ghost-Stein (plus Typ), über den Farben 1..7
+#define GHOST_CELL 8
+
+// Spielfeld, wie die Renderer es zeigen: board (0 = leer, Typ + 1), dazu
+// der Ghost-Stein (GHOST_CELL + Typ), wo ein Hard Drop landen würde, und
+// darüber der fallende Stein. Nach game_over nur board.
+void game_display(const GameState *g, int display[HEIGHT][WIDTH]);
+
+// Vorschau auf n Steine (1..MAX_LOOKAHEAD); ändert die Reihenfolge nicht
+void game_set_lookahead(GameState *g, int n);
+
+// Der n-te kommende Stein (0 = der nächste), n < lookahead
+static inline int peek_piece(const GameState *g, int n)
+{
+    return g->queue[(g->queue_head + n) & (PIECE_QUEUE_SIZE - 1)];
+}
+
+int get_next_piece(GameState *g);
+Tetromino spawn_tetromino(int type);
+
+// Drehen nach SRS (dir = 1 im Uhrzeigersinn, -1 dagegen): höchstens
+// SRS_KICKS Positionen aus der Tabelle, die erste freie gewinnt. Gibt 0
+// zurück (und lässt t unverändert), wenn keine passt.
+int rotate_tetromino(const GameState *g, Tetromino *t, int dir);
+Tetromino create_tetromino(GameState *g);
+
+// Eine Eingabe anwenden (INPUT_NONE = keine) und danach dt ms simulieren.
+// Das Ergebnis hängt nur von der Folge der Eingaben und ihren Zeitpunkten
+// ab, nicht davon, in wie viele Aufrufe die Zeit aufgeteilt wird.
+int game_step(GameState *g, GameInput input, int dt);
+
+#endif
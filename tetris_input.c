@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "tetris_input.h"
+#include "tetris_time.h"
+
+struct InputThread
+{
+    pthread_t thread;
+    int fd;
+    InputDecoder decoder;
+
+    InputEvent *ring;
+    uint32_t mask;
+    atomic_uint_fast32_t head; // Nur der Thread schreibt
+    atomic_uint_fast32_t tail; // Nur der Leser schreibt
+
+    int wake_pipe[2]; // [0] pollt der Leser, [1] beschreibt der Thread
+    int stop_pipe[2]; // [0] pollt der Thread, [1] beschreibt input_thread_stop
+    atomic_int stop;
+    atomic_int closed; // fd ist zu Ende, es kommen keine Tasten mehr
+};
+
+void input_decoder_init(InputDecoder *d)
+{
+    d->state = DECODE_GROUND;
+}
+
+// Endzeichen einer CSI/SS3 Sequenz auf eine Taste abbilden; 0 = ignorieren
+static int final_key(uint8_t c)
+{
+    switch (c)
+    {
+    case 'A':
+        return TERM_KEY_UP;
+    case 'B':
+        return TERM_KEY_DOWN;
+    case 'C':
+        return TERM_KEY_RIGHT;
+    case 'D':
+        return TERM_KEY_LEFT;
+    default:
+        return 0;
+    }
+}
+
+int input_decode(InputDecoder *d, const uint8_t *bytes, int len, int *keys)
+{
+    int n = 0;
+
+    for (int i = 0; i < len; i++)
+    {
+        uint8_t c = bytes[i];
+
+        switch (d->state)
+        {
+        case DECODE_GROUND:
+            if (c == 0x1b)
+                d->state = DECODE_ESC;
+            else
+                keys[n++] = c;
+            break;
+
+        case DECODE_ESC:
+            if (c == '[')
+                d->state = DECODE_CSI;
+            else if (c == 'O')
+                d->state = DECODE_SS3;
+            else
+            {
+                // Keine Sequenz: ESC für sich, das Zeichen normal verarbeiten
+                keys[n++] = TERM_KEY_ESC;
+                d->state = DECODE_GROUND;
+                i--;
+            }
+            break;
+
+        case DECODE_CSI:
+            // Parameter (0x30-0x3f) und Zwischenzeichen (0x20-0x2f)
+            // überspringen, z.B. "1;2A" für Shift+Pfeil
+            if (c >= 0x20 && c <= 0x3f)
+                break;
+            if (c >= 0x40 && c <= 0x7e)
+            {
+                int key = final_key(c);
+                if (key)
+                    keys[n++] = key;
+            }
+            d->state = DECODE_GROUND;
+            break;
+
+        case DECODE_SS3:
+        {
+            int key = final_key(c);
+            if (key)
+                keys[n++] = key;
+            d->state = DECODE_GROUND;
+            break;
+        }
+        }
+    }
+    return n;
+}
+
+// Den Leser wecken, der in poll() auf wake_pipe[0] wartet
+static void wake(InputThread *t)
+{
+    char wake = 1;
+    if (write(t->wake_pipe[1], &wake, 1) < 0)
+    {
+        // Pipe voll: der Leser ist ohnehin schon geweckt
+    }
+}
+
+static void push(InputThread *t, const InputEvent *e)
+{
+    uint32_t head = atomic_load_explicit(&t->head, memory_order_relaxed);
+
+    // Voll: warten, bis der Leser Platz macht, statt die Taste zu verwerfen.
+    // Vorher wecken, sonst schläft der Leser womöglich bis zum nächsten
+    // Fall-Schritt, während der Ring voll ist.
+    if (head - atomic_load_explicit(&t->tail, memory_order_acquire) > t->mask)
+        wake(t);
+    while (head - atomic_load_explicit(&t->tail, memory_order_acquire) > t->mask)
+    {
+        if (atomic_load_explicit(&t->stop, memory_order_relaxed))
+            return;
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+    }
+
+    t->ring[head & t->mask] = *e;
+    atomic_store_explicit(&t->head, head + 1, memory_order_release);
+}
+
+static void *input_main(void *arg)
+{
+    InputThread *t = arg;
+    uint8_t buf[INPUT_READ_SIZE];
+    int keys[INPUT_READ_SIZE];
+
+    while (!atomic_load_explicit(&t->stop, memory_order_relaxed))
+    {
+        // Schlafen, bis Bytes kommen oder input_thread_stop weckt
+        struct pollfd pfd[2] = {{t->fd, POLLIN, 0}, {t->stop_pipe[0], POLLIN, 0}};
+        if (poll(pfd, 2, -1) <= 0 || pfd[1].revents)
+            continue;
+
+        int64_t now = time_now_us();
+
+        // Nach poll() heißt 0 Bytes Dateiende (z.B. stdin aus einer Pipe).
+        // poll() meldet das fd dann immer wieder als lesbar, also hier
+        // aufhören statt die CPU zu verbrennen; input_thread_stop geht
+        // trotzdem.
+        ssize_t len = read(t->fd, buf, sizeof(buf));
+        if (len == 0 || (len < 0 && errno != EINTR && errno != EAGAIN))
+        {
+            // Erst markieren, dann wecken: wer danach aufwacht, sieht closed
+            atomic_store_explicit(&t->closed, 1, memory_order_release);
+            wake(t);
+            break;
+        }
+        if (len < 0)
+            continue;
+
+        int n = input_decode(&t->decoder, buf, (int)len, keys);
+        for (int i = 0; i < n; i++)
+        {
+            InputEvent e = {keys[i], now};
+            push(t, &e);
+        }
+
+        if (n > 0)
+            wake(t);
+    }
+    return NULL;
+}
+
+InputThread *input_thread_start(int fd, int ring_size)
+{
+    InputThread *t = calloc(1, sizeof(InputThread));
+    if (!t)
+        return NULL;
+
+    uint32_t size = 1;
+    while (size < (uint32_t)(ring_size > 1 ? ring_size : 1))
+        size <<= 1;
+
+    t->fd = fd;
+    t->mask = size - 1;
+    t->ring = malloc(size * sizeof(InputEvent));
+    input_decoder_init(&t->decoder);
+
+    if (!t->ring || pipe(t->wake_pipe) != 0)
+    {
+        free(t->ring);
+        free(t);
+        return NULL;
+    }
+    if (pipe(t->stop_pipe) != 0)
+    {
+        close(t->wake_pipe[0]);
+        close(t->wake_pipe[1]);
+        free(t->ring);
+        free(t);
+        return NULL;
+    }
+    fcntl(t->wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(t->wake_pipe[1], F_SETFL, O_NONBLOCK);
+
+    if (pthread_create(&t->thread, NULL, input_main, t) != 0)
+    {
+        close(t->stop_pipe[0]);
+        close(t->stop_pipe[1]);
+        close(t->wake_pipe[0]);
+        close(t->wake_pipe[1]);
+        free(t->ring);
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void input_thread_stop(InputThread *t)
+{
+    if (!t)
+        return;
+
+    atomic_store(&t->stop, 1);
+    char stop = 1;
+    if (write(t->stop_pipe[1], &stop, 1) < 0)
+    {
+        // Kann bei einer frischen Pipe nicht voll sein
+    }
+    pthread_join(t->thread, NULL);
+
+    close(t->stop_pipe[0]);
+    close(t->stop_pipe[1]);
+    close(t->wake_pipe[0]);
+    close(t->wake_pipe[1]);
+    free(t->ring);
+    free(t);
+}
+
+int input_thread_wake_fd(const InputThread *t)
+{
+    return t->wake_pipe[0];
+}
+
+int input_thread_closed(const InputThread *t)
+{
+    return atomic_load_explicit(&t->closed, memory_order_acquire);
+}
+
+int input_thread_pop(InputThread *t, InputEvent *e)
+{
+    uint32_t tail = atomic_load_explicit(&t->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&t->head, memory_order_acquire);
+
+    if (tail == head)
+    {
+        // Weckbytes erst leeren, dann noch einmal nachsehen: was danach
+        // kommt, schreibt ein neues Weckbyte
+        char buf[64];
+        while (read(t->wake_pipe[0], buf, sizeof(buf)) > 0)
+            ;
+        head = atomic_load_explicit(&t->head, memory_order_acquire);
+        if (tail == head)
+            return 0;
+    }
+
+    *e = t->ring[tail & t->mask];
+    atomic_store_explicit(&t->tail, tail + 1, memory_order_release);
+    return 1;
+}
@@ -0,0 +1,71 @@
+#ifndef TETRIS_INPUT_H
+#define TETRIS_INPUT_H
+
+#include <stdint.h>
+
+// Tastatureingabe im Raw Mode ohne ncurses: alle anstehenden Bytes mit
+// einem read() holen und mit einem Zustandsautomaten in Tasten zerlegen.
+// Escape-Sequenzen dürfen dabei über mehrere read() verteilt ankommen.
+
+// Tasten außerhalb von ASCII (wie bei ncurses oberhalb von 0xff)
+#define TERM_KEY_UP 0x101
+#define TERM_KEY_DOWN 0x102
+#define TERM_KEY_RIGHT 0x103
+#define TERM_KEY_LEFT 0x104
+#define TERM_KEY_ESC 0x1b // ESC ohne Sequenz dahinter
+
+// So viele Bytes holt ein read() höchstens
+#define INPUT_READ_SIZE 256
+
+typedef enum
+{
+    DECODE_GROUND, // Normale Zeichen
+    DECODE_ESC,    // ESC gelesen
+    DECODE_CSI,    // ESC [ gelesen, Parameter folgen
+    DECODE_SS3     // ESC O gelesen
+} DecodeState;
+
+typedef struct
+{
+    DecodeState state;
+} InputDecoder;
+
+void input_decoder_init(InputDecoder *d);
+
+// Bytes weiterverarbeiten; schreibt die fertigen Tasten nach keys (höchstens
+// len Stück) und gibt ihre Anzahl zurück. Eine angefangene Sequenz bleibt
+// im Decoder und wird mit den nächsten Bytes fortgesetzt.
+int input_decode(InputDecoder *d, const uint8_t *bytes, int len, int *keys);
+
+// Eingabe-Thread: liest fd, sobald Bytes da sind, versieht jede Taste mit
+// dem Zeitpunkt des read() und legt sie in einen lock-freien Ring (ein
+// Schreiber, ein Leser). Ist der Ring voll, wartet der Thread, bis Platz
+// ist; Tasten gehen nie verloren.
+// Am Dateiende von fd hört der Thread auf zu lesen.
+
+#define INPUT_RING_DEFAULT 1024
+
+typedef struct
+{
+    int key;         // ASCII oder TERM_KEY_*
+    int64_t time_us; // time_now_us() beim Lesen
+} InputEvent;
+
+typedef struct InputThread InputThread;
+
+// ring_size wird auf eine Zweierpotenz aufgerundet; NULL bei Fehlern
+InputThread *input_thread_start(int fd, int ring_size);
+void input_thread_stop(InputThread *t);
+
+// Wird lesbar, sobald neue Tasten im Ring liegen (für poll())
+int input_thread_wake_fd(const InputThread *t);
+
+// Nächste Taste in Lesereihenfolge; 0, wenn der Ring leer ist
+int input_thread_pop(InputThread *t, InputEvent *e);
+
+// 1, wenn fd zu Ende ist: nach dem Leeren des Rings kommt nichts mehr, wer
+// auf eine Taste wartet, muss aufgeben. Der Thread weckt dabei ein letztes
+// Mal über input_thread_wake_fd.
+int input_thread_closed(const InputThread *t);
+
+#endif
@@ -1,623 +1,536 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include <unistd.h>
+#include <poll.h>
+#include <signal.h>
 #include <ncurses.h>
-
-// Spielfeld Dimensionen
-#define WIDTH 10
-#define HEIGHT 20
-
-// Tetromino Formen (7 verschiedene)
-int shapes[7][4][4] = {
-    // I
-    {{0, 0, 0, 0},
-     {1, 1, 1, 1},
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    // O
-    {{0, 0, 0, 0},
-     {0, 1, 1, 0},
-     {0, 1, 1, 0},
-     {0, 0, 0, 0}},
-    // T
-    {{0, 0, 0, 0},
-     {0, 1, 1, 1},
-     {0, 0, 1, 0},
-     {0, 0, 0, 0}},
-    // S
-    {{0, 0, 0, 0},
-     {0, 0, 1, 1},
-     {0, 1, 1, 0},
-     {0, 0, 0, 0}},
-    // Z
-    {{0, 0, 0, 0},
-     {0, 1, 1, 0},
-     {0, 0, 1, 1},
-     {0, 0, 0, 0}},
-    // J
-    {{0, 0, 0, 0},
-     {0, 1, 1, 1},
-     {0, 0, 0, 1},
-     {0, 0, 0, 0}},
-    // L
-    {{0, 0, 0, 0},
-     {0, 1, 1, 1},
-     {0, 1, 0, 0},
-     {0, 0, 0, 0}}};
-
-// Farben (ncurses color pairs)
-#define COLOR_PAIR_I 1
-#define COLOR_PAIR_O 2
-#define COLOR_PAIR_T 3
-#define COLOR_PAIR_S 4
-#define COLOR_PAIR_Z 5
-#define COLOR_PAIR_J 6
-#define COLOR_PAIR_L 7
-
-typedef struct
-{
-    int x, y;
-    int type;
-    int rotation;
-} Tetromino;
-
-int board[HEIGHT][WIDTH] = {0};
-int score = 0;
-int level = 1;
-int lines_cleared = 0;
-int game_over = 0;
-
-// Hold und Next Steine
-int hold_piece = -1; // -1 = kein Stein gespeichert
-int can_hold = 1;    // Kann nur einmal pro Stein gehalten werden
-#define NEXT_PIECES 4
-int next_pieces[NEXT_PIECES];
-
-// Bag System für faire Verteilung
-int bag[7];
-int bag_index = 7; // Startet bei 7, damit sofort ein neuer Bag erstellt wird
-
-void shuffle_bag()
+#include "tetris_core.h"
+#include "tetris_render_curses.h"
+#include "tetris_render_thread.h"
+#include "tetris_input.h"
+#include "tetris_sim.h"
+#include "tetris_ai.h"
+#include "tetris_replay.h"
+#include "tetris_stats.h"
+#include "tetris_trace.h"
+#include "tetris_time.h"
+
+// Autoplayer: alle AUTOPLAY_STEP_MS eine Eingabe, damit man zusehen kann
+#define AUTOPLAY_STEP_MS 40
+
+// Taste (vom InputDecoder) auf Spiel-Eingabe abbilden
+GameInput map_key(int ch)
 {
-    // Alle 7 Steine in den Bag
-    for (int i = 0; i < 7; i++)
-    {
-        bag[i] = i;
-    }
-
-    // Fisher-Yates Shuffle
-    for (int i = 6; i > 0; i--)
-    {
-        int j = rand() % (i + 1);
-        int temp = bag[i];
-        bag[i] = bag[j];
-        bag[j] = temp;
-    }
-
-    bag_index = 0;
+    if (ch == 'q' || ch == 'Q')
+        return INPUT_QUIT;
+    if (ch == TERM_KEY_LEFT || ch == 'a' || ch == 'A')
+        return INPUT_LEFT;
+    if (ch == TERM_KEY_RIGHT || ch == 'd' || ch == 'D')
+        return INPUT_RIGHT;
+    if (ch == TERM_KEY_DOWN || ch == 's' || ch == 'S')
+        return INPUT_SOFT_DROP;
+    if (ch == TERM_KEY_UP || ch == 'w' || ch == 'W')
+        return INPUT_HARD_DROP; // Hard Drop - Stein fällt sofort runter
+    if (ch == 'e' || ch == 'E')
+        return INPUT_HOLD;
+    if (ch == 'r' || ch == 'R')
+        return INPUT_ROTATE;
+    if (ch == 'z' || ch == 'Z')
+        return INPUT_ROTATE_CCW;
+    return INPUT_NONE;
 }
 
-int get_random_piece()
+// Skriptdatei für --headless lesen: Tasten wie im Spiel, '.' wartet einen
+// Fall-Schritt ab, alles andere wird ignoriert
+GameInput *load_script(const char *path, int *len)
 {
-    if (bag_index >= 7)
-    {
-        shuffle_bag();
-    }
-    return bag[bag_index++];
-}
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return NULL;
 
-void init_next_pieces()
-{
-    for (int i = 0; i < NEXT_PIECES; i++)
-    {
-        next_pieces[i] = get_random_piece();
-    }
-}
+    int cap = 256;
+    GameInput *script = malloc(cap * sizeof(GameInput));
+    *len = 0;
 
-int get_next_piece()
-{
-    int piece = next_pieces[0];
-    // Alle nach vorne schieben
-    for (int i = 0; i < NEXT_PIECES - 1; i++)
+    int ch;
+    while ((ch = fgetc(f)) != EOF)
     {
-        next_pieces[i] = next_pieces[i + 1];
+        GameInput input = ch == '.' ? INPUT_WAIT : map_key(ch);
+        if (input == INPUT_NONE || input == INPUT_QUIT)
+            continue;
+        if (*len == cap)
+        {
+            cap *= 2;
+            script = realloc(script, cap * sizeof(GameInput));
+        }
+        script[(*len)++] = input;
     }
-    // Neuen am Ende generieren mit Bag-System
-    next_pieces[NEXT_PIECES - 1] = get_random_piece();
-    return piece;
+    fclose(f);
+    return script;
 }
 
-void init_colors()
+// Spiele ohne Darstellung so schnell wie möglich durchlaufen lassen. Im
+// Turnier laufen die Spiele parallel und die Verteilung wird ausgegeben.
+int run_headless(int argc, char *argv[], int tournament)
 {
-    start_color();
-    // Farbige Blöcke mit schwarzem Hintergrund
-    init_pair(COLOR_PAIR_I, COLOR_BLACK, COLOR_CYAN);    // I - Cyan
-    init_pair(COLOR_PAIR_O, COLOR_BLACK, COLOR_YELLOW);  // O - Gelb
-    init_pair(COLOR_PAIR_T, COLOR_BLACK, COLOR_MAGENTA); // T - Magenta
-    init_pair(COLOR_PAIR_S, COLOR_BLACK, COLOR_GREEN);   // S - Grün
-    init_pair(COLOR_PAIR_Z, COLOR_BLACK, COLOR_RED);     // Z - Rot
-    init_pair(COLOR_PAIR_J, COLOR_BLACK, COLOR_BLUE);    // J - Blau
-    init_pair(COLOR_PAIR_L, COLOR_BLACK, COLOR_WHITE);   // L - Weiß
-    init_pair(8, COLOR_WHITE, COLOR_BLACK);              // Für Rahmen
-    init_pair(9, COLOR_BLACK, COLOR_BLACK);              // Dunkles Schachbrett
-}
+    SimOptions opt = {&rules_ncurses, 1000, 0, NULL, 0, 0, NULL, seed_from_args(argc, argv)};
+    GameInput *script = NULL;
+    int threads = tournament ? 0 : 1; // 0 = alle Kerne
+    int depth = 1;
 
-void rotate_shape(int shape[4][4], int rotated[4][4])
-{
-    for (int i = 0; i < 4; i++)
+    for (int i = 1; i < argc; i++)
     {
-        for (int j = 0; j < 4; j++)
+        if (strncmp(argv[i], "--games=", 8) == 0)
+            opt.games = atoi(argv[i] + 8);
+        else if (strncmp(argv[i], "--max-pieces=", 13) == 0)
+            opt.max_pieces = atoi(argv[i] + 13);
+        else if (strncmp(argv[i], "--script=", 9) == 0)
         {
-            rotated[i][j] = shape[3 - j][i];
+            script = load_script(argv[i] + 9, &opt.script_len);
+            if (!script || opt.script_len == 0)
+            {
+                fprintf(stderr, "Skript %s leer oder nicht lesbar\n", argv[i] + 9);
+                return 1;
+            }
+            opt.script = script;
         }
+        else if (strcmp(argv[i], "--ai") == 0)
+            opt.ai = 1;
+        else if (strncmp(argv[i], "--threads=", 10) == 0)
+            threads = atoi(argv[i] + 10);
+        else if (strncmp(argv[i], "--ai-depth=", 11) == 0)
+            depth = atoi(argv[i] + 11);
     }
-}
 
-int check_collision(Tetromino *t)
-{
-    int current_shape[4][4];
-    memcpy(current_shape, shapes[t->type], sizeof(current_shape));
+    // Der Autoplayer stirbt selten von selbst
+    if (opt.ai && opt.max_pieces == 0)
+        opt.max_pieces = 10000;
 
-    for (int r = 0; r < t->rotation % 4; r++)
+    if (tournament)
     {
-        int temp[4][4];
-        rotate_shape(current_shape, temp);
-        memcpy(current_shape, temp, sizeof(current_shape));
+        // Ein Pool ohne eigene Threads für alle Spiele: nur Suchtiefe und
+        // gemeinsame Transpositionstabelle
+        if (opt.ai)
+            opt.ai_pool = ai_pool_create(1, depth);
+
+        GameResult *results = malloc((opt.games > 0 ? opt.games : 1) * sizeof(GameResult));
+        SimResult total;
+        sim_tournament(&opt, threads, results, &total);
+        printf("Seed:    %llu\n", (unsigned long long)opt.seed);
+        sim_print_result(stdout, &total);
+        sim_print_distribution(stdout, results, opt.games);
+        ai_pool_destroy(opt.ai_pool);
+        free(results);
+        free(script);
+        return 0;
     }
 
-    for (int i = 0; i < 4; i++)
-    {
-        for (int j = 0; j < 4; j++)
-        {
-            if (current_shape[i][j])
-            {
-                int x = t->x + j;
-                int y = t->y + i;
+    if (opt.ai)
+        opt.ai_pool = ai_pool_create(threads, depth);
 
-                if (x < 0 || x >= WIDTH || y >= HEIGHT)
-                    return 1;
-                if (y >= 0 && board[y][x])
-                    return 1;
-            }
-        }
-    }
+    SimResult result;
+    sim_run(&opt, &result);
+    printf("Seed:    %llu\n", (unsigned long long)opt.seed);
+    sim_print_result(stdout, &result);
+
+    ai_pool_destroy(opt.ai_pool);
+    free(script);
     return 0;
 }
 
-void merge_tetromino(Tetromino *t)
+// Spielfeld als Text, für die Ausgabe ohne Darstellung; der fallende Stein
+// wird als <> gezeigt
+void print_board(FILE *out, const GameState *g)
 {
-    int current_shape[4][4];
-    memcpy(current_shape, shapes[t->type], sizeof(current_shape));
-
-    for (int r = 0; r < t->rotation % 4; r++)
+    uint16_t current[HEIGHT] = {0};
+    if (!g->game_over)
     {
-        int temp[4][4];
-        rotate_shape(current_shape, temp);
-        memcpy(current_shape, temp, sizeof(current_shape));
+        const PieceRotation *p = &piece_table[g->current.type][g->current.rotation % 4];
+        for (int c = 0; c < 4; c++)
+        {
+            int y = g->current.y + p->cells[c][0];
+            int x = g->current.x + p->cells[c][1];
+            if (y >= 0 && y < HEIGHT && x >= 0 && x < WIDTH)
+                current[y] |= 1u << x;
+        }
     }
 
-    for (int i = 0; i < 4; i++)
+    for (int i = 0; i < HEIGHT; i++)
     {
-        for (int j = 0; j < 4; j++)
-        {
-            if (current_shape[i][j])
-            {
-                int x = t->x + j;
-                int y = t->y + i;
-                if (y >= 0 && y < HEIGHT && x >= 0 && x < WIDTH)
-                {
-                    board[y][x] = t->type + 1;
-                }
-            }
-        }
+        fputc('|', out);
+        for (int j = 0; j < WIDTH; j++)
+            fputs(current[i] & (1u << j) ? "<>" : g->board[i][j] ? "[]" : " .", out);
+        fputs("|\n", out);
     }
 }
 
-int clear_lines()
+// Replay abspielen: mit --fast ohne Darstellung so schnell wie möglich (und
+// mit --at=ms den Zustand zu diesem Zeitpunkt ausgeben), sonst in Echtzeit
+// ab --at. Während der Wiedergabe springen <- und -> 10 s zurück/vor.
+int run_replay(int argc, char *argv[], const char *path)
 {
-    int cleared = 0;
+    int fast = 0;
+    int64_t at = -1;
 
-    for (int i = HEIGHT - 1; i >= 0; i--)
+    for (int i = 1; i < argc; i++)
     {
-        int full = 1;
-        for (int j = 0; j < WIDTH; j++)
-        {
-            if (!board[i][j])
-            {
-                full = 0;
-                break;
-            }
-        }
+        if (strcmp(argv[i], "--fast") == 0)
+            fast = 1;
+        else if (strncmp(argv[i], "--at=", 5) == 0)
+            at = strtoll(argv[i] + 5, NULL, 10);
+    }
 
-        if (full)
-        {
-            cleared++;
-            for (int k = i; k > 0; k--)
-            {
-                for (int j = 0; j < WIDTH; j++)
-                {
-                    board[k][j] = board[k - 1][j];
-                }
-            }
-            for (int j = 0; j < WIDTH; j++)
-            {
-                board[0][j] = 0;
-            }
-            i++;
-        }
+    int64_t start = time_now_us();
+    ReplayPlayer player;
+    if (!replay_player_open(&player, path, REPLAY_KEYFRAME_MS))
+    {
+        fprintf(stderr, "Replay %s nicht lesbar\n", path);
+        return 1;
     }
+    double index_seconds = (time_now_us() - start) / 1e6;
 
-    return cleared;
-}
+    if (fast)
+    {
+        // Beim Öffnen wurde schon alles durchgerechnet
+        start = time_now_us();
+        replay_player_seek(&player, at >= 0 ? at : player.end_ms);
+        double seek_seconds = (time_now_us() - start) / 1e6;
+
+        const GameState *g = &player.game;
+        printf("Seed:     %llu\n", (unsigned long long)player.seed);
+        printf("Dauer:    %.1f s\n", player.end_ms / 1000.0);
+        printf("Eingaben: %d\n", player.inputs);
+        printf("Index:    %.3f s, %d Keyframes\n", index_seconds, player.keyframe_count);
+        printf("Sprung:   %.6f s\n", seek_seconds);
+        printf("Zeit:     %.3f s\n", g->time_ms / 1000.0);
+        printf("Steine:   %d\n", g->pieces);
+        printf("Punkte:   %d\n", g->score);
+        printf("Linien:   %d\n", g->lines_cleared);
+        printf("Level:    %d\n", g->level);
+        print_board(stdout, g);
+
+        replay_player_close(&player);
+        return 0;
+    }
 
-void draw_board(Tetromino *current)
-{
-    clear();
+    if (at > 0)
+        replay_player_seek(&player, at);
 
-    // Titel
-    mvprintw(0, 2, "=== TETRIS ===");
-    mvprintw(1, 2, "Score: %d  Level: %d  Lines: %d", score, level, lines_cleared);
-    mvprintw(2, 2, "<- -> : Bewegen  |  v : Runter  |  ^/W : Hard Drop  |  R : Rotieren  |  E : Hold  |  Q : Beenden");
+    initscr();
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    nodelay(stdscr, TRUE);
+    curs_set(0);
 
-    // Temporäres Board für Anzeige
-    int display[HEIGHT][WIDTH];
-    memcpy(display, board, sizeof(board));
+    curses_init_colors();
 
-    // Aktuellen Tetromino hinzufügen
-    if (current)
-    {
-        int current_shape[4][4];
-        memcpy(current_shape, shapes[current->type], sizeof(current_shape));
+    SimClock sim;
+    sim_clock_start(&sim);
+    int64_t target = player.game.time_ms;
+    int paused = 0;
+    int quit = 0;
+    int shown_tenths = -1;
 
-        for (int r = 0; r < current->rotation % 4; r++)
+    while (!quit)
+    {
+        int timeout = paused || target >= player.end_ms ? -1 : sim_clock_timeout_ms(&sim, (player.game.fall_speed - player.game.fall_timer) / SIM_STEP_MS);
+        if (timeout != 0)
         {
-            int temp[4][4];
-            rotate_shape(current_shape, temp);
-            memcpy(current_shape, temp, sizeof(current_shape));
+            // Anzeige der Zeit mindestens alle 100 ms nachführen
+            struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+            poll(&pfd, 1, timeout < 0 || timeout > 100 ? 100 : timeout);
         }
 
-        for (int i = 0; i < 4; i++)
+        int steps = sim_clock_advance(&sim);
+        if (!paused)
+            target += steps * SIM_STEP_MS;
+        if (target > player.end_ms)
+            target = player.end_ms;
+        replay_player_advance(&player, target);
+
+        int ch;
+        while ((ch = getch()) != ERR)
         {
-            for (int j = 0; j < 4; j++)
+            if (ch == 'q' || ch == 'Q')
+                quit = 1;
+            else if (ch == ' ')
             {
-                if (current_shape[i][j])
-                {
-                    int x = current->x + j;
-                    int y = current->y + i;
-                    if (y >= 0 && y < HEIGHT && x >= 0 && x < WIDTH)
-                    {
-                        display[y][x] = current->type + 1;
-                    }
-                }
+                paused = !paused;
+                shown_tenths = -1;
             }
-        }
-    }
-
-    // Spielfeld zeichnen
-    int start_y = 4;
-    int start_x = 2;
-
-    // Oberer Rand
-    attron(COLOR_PAIR(8) | A_BOLD);
-    mvaddch(start_y, start_x, '+');
-    for (int i = 0; i < WIDTH * 2; i++)
-        addch('=');
-    addch('+');
-    attroff(COLOR_PAIR(8) | A_BOLD);
-
-    // Spielfeld
-    for (int i = 0; i < HEIGHT; i++)
-    {
-        attron(COLOR_PAIR(8) | A_BOLD);
-        mvaddch(start_y + i + 1, start_x, '|');
-        attroff(COLOR_PAIR(8) | A_BOLD);
-
-        for (int j = 0; j < WIDTH; j++)
-        {
-            if (display[i][j])
+            else if (ch == KEY_LEFT || ch == KEY_RIGHT)
             {
-                // Farbige Blöcke mit fettem Text
-                attron(COLOR_PAIR(display[i][j]) | A_BOLD);
-                addstr("  "); // Volle Blöcke
-                attroff(COLOR_PAIR(display[i][j]) | A_BOLD);
+                target += ch == KEY_LEFT ? -10000 : 10000;
+                if (target < 0)
+                    target = 0;
+                if (target > player.end_ms)
+                    target = player.end_ms;
+                replay_player_seek(&player, target);
             }
-            else
+            else if (ch == KEY_RESIZE)
             {
-                // Raster mit einfachen Punkten (jede 2. Zeile und Spalte)
-                if (i % 2 == 0 && j % 2 == 0)
-                {
-                    attron(A_DIM);
-                    addstr(". ");
-                    attroff(A_DIM);
-                }
-                else
-                {
-                    addstr("  ");
-                }
+                curses_invalidate();
+                shown_tenths = -1;
             }
         }
 
-        attron(COLOR_PAIR(8) | A_BOLD);
-        addch('|');
-        attroff(COLOR_PAIR(8) | A_BOLD);
-    }
-
-    // Unterer Rand
-    attron(COLOR_PAIR(8) | A_BOLD);
-    mvaddch(start_y + HEIGHT + 1, start_x, '+');
-    for (int i = 0; i < WIDTH * 2; i++)
-        addch('=');
-    addch('+');
-    attroff(COLOR_PAIR(8) | A_BOLD);
-
-    // HOLD Box zeichnen (links vom Spielfeld)
-    int hold_x = start_x + WIDTH * 2 + 5;
-    mvprintw(start_y, hold_x, "HOLD (E):");
-    mvaddch(start_y + 1, hold_x, '+');
-    for (int i = 0; i < 10; i++)
-        addch('-');
-    addch('+');
-
-    for (int i = 0; i < 4; i++)
-    {
-        mvaddch(start_y + 2 + i, hold_x, '|');
-        for (int j = 0; j < 5; j++)
-            addstr("  ");
-        addch('|');
-    }
-
-    mvaddch(start_y + 6, hold_x, '+');
-    for (int i = 0; i < 10; i++)
-        addch('-');
-    addch('+');
+        curses_draw_board(&player.game);
 
-    // Hold Piece zeichnen
-    if (hold_piece >= 0)
-    {
-        for (int i = 0; i < 4; i++)
+        int tenths = (int)(target / 100);
+        if (tenths != shown_tenths)
         {
-            for (int j = 0; j < 4; j++)
-            {
-                if (shapes[hold_piece][i][j])
-                {
-                    attron(COLOR_PAIR(hold_piece + 1) | A_BOLD);
-                    mvaddstr(start_y + 2 + i, hold_x + 2 + j * 2, "  ");
-                    attroff(COLOR_PAIR(hold_piece + 1) | A_BOLD);
-                }
-            }
+            mvprintw(2, 2, "REPLAY %d:%04.1f / %d:%04.1f%s  |  <- -> : 10 s  |  Leertaste : Pause  |  Q : Beenden",
+                     (int)(target / 60000), (target % 60000) / 1000.0,
+                     (int)(player.end_ms / 60000), (player.end_ms % 60000) / 1000.0,
+                     paused ? " (Pause)" : "");
+            clrtoeol();
+            refresh();
+            shown_tenths = tenths;
         }
     }
 
-    // NEXT Boxes zeichnen (rechts vom Spielfeld)
-    int next_x = hold_x + 15;
-    mvprintw(start_y, next_x, "NEXT:");
-
-    for (int n = 0; n < NEXT_PIECES; n++)
-    {
-        int box_y = start_y + 1 + n * 5;
-
-        mvaddch(box_y, next_x, '+');
-        for (int i = 0; i < 10; i++)
-            addch('-');
-        addch('+');
+    endwin();
+    replay_player_close(&player);
+    return 0;
+}
 
-        for (int i = 0; i < 4; i++)
-        {
-            mvaddch(box_y + 1 + i, next_x, '|');
-            for (int j = 0; j < 5; j++)
-                addstr("  ");
-            addch('|');
-        }
+// Terminalgröße geändert: getch() sieht das nicht mehr, weil der
+// Eingabe-Thread stdin liest
+static volatile sig_atomic_t resized = 0;
 
-        // Next Piece zeichnen
-        for (int i = 0; i < 4; i++)
-        {
-            for (int j = 0; j < 4; j++)
-            {
-                if (shapes[next_pieces[n]][i][j])
-                {
-                    attron(COLOR_PAIR(next_pieces[n] + 1) | A_BOLD);
-                    mvaddstr(box_y + 1 + i, next_x + 2 + j * 2, "  ");
-                    attroff(COLOR_PAIR(next_pieces[n] + 1) | A_BOLD);
-                }
-            }
-        }
-    }
-
-    refresh();
+static void on_sigwinch(int sig)
+{
+    (void)sig;
+    resized = 1;
 }
 
-Tetromino create_tetromino()
+// Läuft im Render-Thread: ncurses die neue Größe holen lassen
+static void resize_screen()
 {
-    Tetromino t;
-    t.type = get_next_piece(); // Benutze Next-System
-    t.x = WIDTH / 2 - 2;
-    t.y = -1;
-    t.rotation = 0;
-    return t;
+    endwin();
+    refresh();
+    curses_invalidate();
 }
 
-int main()
+int main(int argc, char *argv[])
 {
-    srand(time(NULL));
+    int autoplay = 0;
+    int threads = 1;
+    int depth = 1;
+    const char *record_path = NULL;
+    const char *trace_path = NULL;
+    int ring_size = INPUT_RING_DEFAULT;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+            return run_headless(argc, argv, 0);
+        if (strcmp(argv[i], "--tournament") == 0)
+            return run_headless(argc, argv, 1);
+        if (strncmp(argv[i], "--replay=", 9) == 0)
+            return run_replay(argc, argv, argv[i] + 9);
+        if (strcmp(argv[i], "--autoplay") == 0)
+            autoplay = 1;
+        else if (strncmp(argv[i], "--threads=", 10) == 0)
+            threads = atoi(argv[i] + 10);
+        else if (strncmp(argv[i], "--record=", 9) == 0)
+            record_path = argv[i] + 9;
+        else if (strncmp(argv[i], "--stats=", 8) == 0)
+            stats_init(argv[i] + 8);
+        else if (strncmp(argv[i], "--trace=", 8) == 0)
+            trace_path = argv[i] + 8;
+        else if (strncmp(argv[i], "--input-ring=", 13) == 0)
+            ring_size = atoi(argv[i] + 13);
+        else if (strncmp(argv[i], "--ai-depth=", 11) == 0)
+            depth = atoi(argv[i] + 11);
+    }
+
+    // Geplante Eingaben des Autoplayers für den aktuellen Stein
+    AiPool *pool = autoplay ? ai_pool_create(threads, depth) : NULL;
+    GameInput plan[AI_MAX_INPUTS];
+    int plan_len = 0, plan_pos = 0;
+    int64_t next_bot_ms = 0;
 
-    // ncurses initialisieren
+    GameState game;
+    game_init(&game, &rules_ncurses, seed_from_args(argc, argv));
+    if (trace_path && !trace_open(trace_path))
+    {
+        fprintf(stderr, "Trace %s kann nicht angelegt werden\n", trace_path);
+        ai_pool_destroy(pool);
+        return 1;
+    }
+    LoopProbe probe = {0};
+    if (stats_enabled || trace_enabled)
+    {
+        game.probe = trace_loop_probe;
+        game.probe_ctx = &probe;
+    }
+
+    ReplayWriter *replay = NULL;
+    if (record_path && !(replay = replay_open(record_path, &game)))
+    {
+        fprintf(stderr, "Replay %s kann nicht angelegt werden\n", record_path);
+        ai_pool_destroy(pool);
+        return 1;
+    }
+
+    // ncurses initialisieren; Tasten liest der Eingabe-Thread direkt von
+    // stdin, ncurses zeichnet nur noch (im Render-Thread)
     initscr();
     cbreak();
     noecho();
-    keypad(stdscr, TRUE);
-    nodelay(stdscr, TRUE);
     curs_set(0);
 
-    init_colors();
+    curses_init_colors();
+
+    struct sigaction sa = {0};
+    sa.sa_handler = on_sigwinch;
+    sigaction(SIGWINCH, &sa, NULL);
+
+    InputThread *input = input_thread_start(STDIN_FILENO, ring_size);
+    static const Renderer renderer = {curses_compose, curses_flush, resize_screen, "refresh"};
+    RenderThread *render = input ? render_thread_start(&renderer) : NULL;
+    if (!render)
+    {
+        input_thread_stop(input);
+        endwin();
+        fprintf(stderr, "Eingabe- oder Render-Thread kann nicht gestartet werden\n");
+        replay_close(replay);
+        ai_pool_destroy(pool);
+        return 1;
+    }
 
-    init_next_pieces(); // Next Pieces initialisieren
+    // Alle Hilfsthreads laufen und haben SIGUSR1 blockiert geerbt
+    stats_unblock_signal();
 
-    Tetromino current = create_tetromino();
+    SimClock sim;
+    sim_clock_start(&sim);
+    render_publish(render, &game, 0);
 
-    clock_t last_fall = clock();
-    int fall_speed = 500000; // 500ms
+    // Zeitpunkt, zu dem die älteste Taste seit dem letzten übergebenen Frame
+    // gelesen wurde (0 = keine), für die Latenz bis zur Ausgabe
+    int64_t key_read_ns = 0;
 
-    while (!game_over)
+    while (!game.game_over)
     {
-        // Input verarbeiten
-        int ch = getch();
+        // Blockieren bis eine Taste kommt oder der nächste Fall-Schritt
+        // fällig ist, statt alle 10ms aufzuwachen
+        int timeout = sim_clock_timeout_ms(&sim, (game.fall_speed - game.fall_timer) / SIM_STEP_MS);
+        if (autoplay)
+        {
+            int bot = sim_clock_timeout_ms(&sim, (int)(next_bot_ms - game.time_ms) / SIM_STEP_MS);
+            if (bot < timeout)
+                timeout = bot;
+        }
+        if (timeout > 0)
+        {
+            struct pollfd pfd = {input_thread_wake_fd(input), POLLIN, 0};
+            int64_t t_sleep = trace_now();
+            poll(&pfd, 1, timeout);
+            trace_complete("Schlafen", t_sleep, trace_now());
+        }
+        stats_poll();
+        if (resized)
+        {
+            resized = 0;
+            render_invalidate(render);
+        }
 
-        if (ch != ERR)
+        // Tasten in Lesereihenfolge anwenden, die Simulation vorher jeweils
+        // bis zum Zeitstempel der Taste nachziehen
+        int events = 0;
+        int64_t t_input = trace_now();
+        InputEvent ev;
+        while (!game.game_over && input_thread_pop(input, &ev))
         {
-            Tetromino temp = current;
+            int steps = sim_clock_advance_to(&sim, ev.time_us);
+            if (steps > 0)
+                events |= game_step(&game, INPUT_NONE, steps * SIM_STEP_MS);
+            if (game.game_over)
+                break;
 
-            if (ch == 'q' || ch == 'Q')
-            {
-                game_over = 1;
-                continue;
-            }
-            else if (ch == KEY_LEFT || ch == 'a' || ch == 'A')
-            {
-                temp.x--;
-                if (!check_collision(&temp))
-                    current = temp;
-            }
-            else if (ch == KEY_RIGHT || ch == 'd' || ch == 'D')
-            {
-                temp.x++;
-                if (!check_collision(&temp))
-                    current = temp;
-            }
-            else if (ch == KEY_DOWN || ch == 's' || ch == 'S')
-            {
-                temp.y++;
-                if (!check_collision(&temp))
-                    current = temp;
-            }
-            else if (ch == KEY_UP || ch == 'w' || ch == 'W')
-            {
-                // Hard Drop - Stein fällt sofort runter
-                while (!check_collision(&temp))
-                {
-                    current = temp;
-                    temp.y++;
-                }
-                // Sofort mergen und neuen Stein
-                merge_tetromino(&current);
-
-                int cleared = clear_lines();
-                if (cleared > 0)
-                {
-                    lines_cleared += cleared;
-                    score += cleared * cleared * 100;
-                    level = 1 + lines_cleared / 5;             // Level up alle 5 Linien (statt 10)
-                    fall_speed = 500000 - (level - 1) * 50000; // Schnellere Steigerung
-                    if (fall_speed < 50000)
-                        fall_speed = 50000; // Schnelleres Minimum
-                }
-
-                current = create_tetromino();
-
-                if (check_collision(&current))
-                {
-                    game_over = 1;
-                }
-
-                last_fall = clock(); // Timer zurücksetzen
-                can_hold = 1;        // Nach Hard Drop kann wieder gehalten werden
-            }
-            else if (ch == 'e' || ch == 'E')
-            {
-                // Hold Funktion
-                if (can_hold)
-                {
-                    if (hold_piece == -1)
-                    {
-                        // Erstes Mal halten - speichere aktuellen Stein
-                        hold_piece = current.type;
-                        current = create_tetromino();
-                    }
-                    else
-                    {
-                        // Tausche mit gehaltenem Stein
-                        int temp_type = current.type;
-                        current.type = hold_piece;
-                        current.x = WIDTH / 2 - 2;
-                        current.y = -1;
-                        current.rotation = 0;
-                        hold_piece = temp_type;
-
-                        // Prüfe ob der getauschte Stein passt
-                        if (check_collision(&current))
-                        {
-                            // Wenn nicht, Game Over
-                            game_over = 1;
-                        }
-                    }
-                    can_hold = 0; // Kann nur einmal pro Stein benutzt werden
-                }
-            }
-            else if (ch == 'r' || ch == 'R')
-            {
-                temp.rotation++;
-                if (!check_collision(&temp))
-                    current = temp;
-            }
+            GameInput key = map_key(ev.key);
+            replay_record(replay, &game, key);
+            int key_events = game_step(&game, key, 0);
+            if (key_events && key_read_ns == 0)
+                key_read_ns = ev.time_us * 1000;
+            events |= key_events;
         }
 
-        // Automatisches Fallen
-        clock_t now = clock();
-        if ((now - last_fall) * 1000000 / CLOCKS_PER_SEC >= fall_speed)
+        // Simulation in festen Schritten bis jetzt nachziehen
+        int64_t t_sim = trace_now();
+        stats_record(STATS_INPUT, t_sim - t_input);
+        trace_complete("Eingabe", t_input, t_sim);
+        int steps = sim_clock_advance(&sim);
+        if (steps > 0)
+            events |= game_step(&game, INPUT_NONE, steps * SIM_STEP_MS);
+        if (events & GAME_EVENT_LOCKED)
         {
-            Tetromino temp = current;
-            temp.y++;
+            plan_len = plan_pos = 0; // Plan gilt nicht mehr für den neuen Stein
+        }
 
-            if (check_collision(&temp))
-            {
-                merge_tetromino(&current);
-
-                int cleared = clear_lines();
-                if (cleared > 0)
-                {
-                    lines_cleared += cleared;
-                    score += cleared * cleared * 100;
-                    level = 1 + lines_cleared / 5;             // Level up alle 5 Linien (statt 10)
-                    fall_speed = 500000 - (level - 1) * 50000; // Schnellere Steigerung
-                    if (fall_speed < 50000)
-                        fall_speed = 50000; // Schnelleres Minimum
-                }
-
-                current = create_tetromino();
-                can_hold = 1; // Neuer Stein, kann wieder gehalten werden
-
-                if (check_collision(&current))
-                {
-                    game_over = 1;
-                }
-            }
-            else
+        int64_t t_bot = trace_now();
+        stats_record(STATS_SIM, t_bot - t_sim);
+        trace_complete("Schwerkraft", t_sim, t_bot);
+
+        if (autoplay && !game.game_over && game.time_ms >= next_bot_ms)
+        {
+            if (plan_pos >= plan_len)
             {
-                current = temp;
+                AiPlacement best;
+                plan_len = ai_find_best(pool, &game, &best) ? ai_placement_inputs(&game, &best, plan) : 0;
+                if (plan_len == 0)
+                    plan[plan_len++] = INPUT_HARD_DROP;
+                plan_pos = 0;
             }
-
-            last_fall = now;
+            replay_record(replay, &game, plan[plan_pos]);
+            int bot_events = game_step(&game, plan[plan_pos++], 0);
+            if (bot_events & GAME_EVENT_LOCKED)
+                plan_len = plan_pos = 0;
+            events |= bot_events;
+            next_bot_ms = game.time_ms + AUTOPLAY_STEP_MS;
+            trace_complete("Autoplayer", t_bot, trace_now());
         }
 
-        draw_board(&current);
-        usleep(10000); // 10ms
+        // Alle Änderungen eines Aufwachens landen in einem Frame
+        if (events)
+        {
+            int64_t t_publish = trace_now();
+            render_publish(render, &game, key_read_ns);
+            trace_complete("Frame übergeben", t_publish, trace_now());
+        }
+        key_read_ns = 0;
     }
 
+    render_thread_stop(render);
+
+    // Aufnahme schon jetzt abschließen, nicht erst nach dem Tastendruck
+    replay_close(replay);
+
     // Game Over Bildschirm
     clear();
     mvprintw(10, 10, "=== GAME OVER ===");
-    mvprintw(12, 10, "Final Score: %d", score);
-    mvprintw(13, 10, "Level: %d", level);
-    mvprintw(14, 10, "Lines: %d", lines_cleared);
-    mvprintw(16, 10, "Druecke eine Taste zum Beenden...");
+    mvprintw(12, 10, "Final Score: %d", game.score);
+    mvprintw(13, 10, "Level: %d", game.level);
+    mvprintw(14, 10, "Lines: %d", game.lines_cleared);
+    mvprintw(15, 10, "Seed: %llu", (unsigned long long)game.seed);
+    mvprintw(17, 10, "Druecke eine Taste zum Beenden...");
     refresh();
 
-    nodelay(stdscr, FALSE);
-    getch();
+    InputEvent ev;
+    while (!input_thread_pop(input, &ev) && !input_thread_closed(input))
+    {
+        struct pollfd pfd = {input_thread_wake_fd(input), POLLIN, 0};
+        poll(&pfd, 1, -1);
+    }
+    input_thread_stop(input);
 
     endwin();
 
+    stats_finish();
+    trace_close();
+    ai_pool_destroy(pool);
     return 0;
 }
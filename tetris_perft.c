@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_core.h"
+#include "tetris_time.h"
+
+// Perft wie bei Schach-Engines: zählt alle verschiedenen Endlagen, die der
+// aktuelle Stein mit den echten Bewegungen (links, rechts, Soft Drop, in
+// beide Richtungen drehen, Hold) erreichen kann, und den Baum daraus bis
+// zur Tiefe N. Schwerkraft spielt keine Rolle, jede Lage ist beliebig lange
+// erreichbar. Zwei Endlagen sind gleich, wenn sie dieselben Zellen belegen.
+//
+//   ./tetris_perft --depth=3                    leeres Feld, Steine aus Seed
+//   ./tetris_perft --board=feld.txt --queue=TSZ Spielfeld ('#' = belegt,
+//                                               unten ausgerichtet) und
+//                                               Steinfolge vorgeben
+//   ./tetris_perft --depth=2 --divide           Zählung pro erster Lage
+//   ./tetris_perft --no-hold                    Hold nicht als Zug zählen
+
+#define MAX_DEPTH 8
+
+// Erreichbare Lagen: x von -3 bis WIDTH - 1, y ab -Y_OFFSET (Kicks heben
+// den Stein höchstens etwas über den Rand)
+#define Y_OFFSET 8
+#define STATE_COLS (WIDTH + 3)
+#define STATE_ROWS (HEIGHT + Y_OFFSET)
+#define MAX_STATES (4 * STATE_ROWS * STATE_COLS)
+
+// Höchstens so viele Endlagen pro Stein
+#define MAX_PLACEMENTS 512
+
+// 0 mit --no-hold: nur Endlagen des aktuellen Steins
+static int hold_moves = 1;
+
+typedef struct
+{
+    Tetromino piece[MAX_PLACEMENTS];
+    int count;
+} PlacementList;
+
+static int state_index(const Tetromino *t)
+{
+    return ((t->rotation & 3) * STATE_ROWS + t->y + Y_OFFSET) * STATE_COLS + t->x + 3;
+}
+
+// Belegte Zellen als Schlüssel: die 4 Zellindizes sortiert, je 16 Bit
+static uint64_t cells_key(const Tetromino *t)
+{
+    const PieceRotation *p = &piece_table[t->type][t->rotation & 3];
+    int cells[4];
+    for (int k = 0; k < 4; k++)
+    {
+        cells[k] = (t->y + p->cells[k][0] + Y_OFFSET) * WIDTH + t->x + p->cells[k][1];
+    }
+
+    // cells sind schon nach Zeile sortiert, nur innerhalb gleicher Zeilen
+    // kann die Reihenfolge je nach Rotation anders sein
+    for (int i = 1; i < 4; i++)
+    {
+        for (int j = i; j > 0 && cells[j - 1] > cells[j]; j--)
+        {
+            int temp = cells[j];
+            cells[j] = cells[j - 1];
+            cells[j - 1] = temp;
+        }
+    }
+    return (uint64_t)cells[0] << 48 | (uint64_t)cells[1] << 32 | (uint64_t)cells[2] << 16 | cells[3];
+}
+
+// Alle Endlagen des aktuellen Steins per Breitensuche über die Eingaben
+static void generate(const GameState *g, PlacementList *out)
+{
+    static uint8_t visited[MAX_STATES];
+    static Tetromino queue[MAX_STATES];
+    static uint64_t keys[MAX_PLACEMENTS];
+
+    out->count = 0;
+    if (check_collision(g, &g->current))
+        return;
+
+    memset(visited, 0, sizeof(visited));
+    int head = 0, tail = 0;
+    queue[tail++] = g->current;
+    visited[state_index(&g->current)] = 1;
+
+    while (head < tail)
+    {
+        Tetromino t = queue[head++];
+
+        // Endlage, wenn es nach unten nicht weitergeht
+        Tetromino below = t;
+        below.y++;
+        if (check_collision(g, &below))
+        {
+            uint64_t key = cells_key(&t);
+            int seen = 0;
+            for (int i = 0; i < out->count && !seen; i++)
+                seen = keys[i] == key;
+            if (!seen && out->count < MAX_PLACEMENTS)
+            {
+                keys[out->count] = key;
+                out->piece[out->count++] = t;
+            }
+        }
+
+        Tetromino next[5] = {t, t, below, t, t};
+        int valid[5];
+        next[0].x--;
+        next[1].x++;
+        valid[0] = !check_collision(g, &next[0]);
+        valid[1] = !check_collision(g, &next[1]);
+        valid[2] = !check_collision(g, &next[2]);
+        valid[3] = rotate_tetromino(g, &next[3], 1);
+        valid[4] = rotate_tetromino(g, &next[4], -1);
+
+        for (int m = 0; m < 5; m++)
+        {
+            if (!valid[m] || next[m].y < -Y_OFFSET)
+                continue;
+            int index = state_index(&next[m]);
+            if (visited[index])
+                continue;
+            visited[index] = 1;
+            queue[tail++] = next[m];
+        }
+    }
+}
+
+// Stein in der Endlage t einrasten lassen, wie das Spiel es tut
+static void place(GameState *g, const Tetromino *t)
+{
+    g->current = *t;
+    game_step(g, INPUT_HARD_DROP, 0);
+}
+
+static uint64_t perft(const GameState *g, int depth);
+
+// Alle Züge: Endlagen des aktuellen Steins, dann (falls erlaubt und nicht
+// --no-hold) die nach Hold. Zählt die Blätter in Tiefe depth; mit divide wird jeder Zug mit
+// seiner Zählung ausgegeben.
+static uint64_t for_each_move(const GameState *g, int depth, int divide)
+{
+    // Eine Liste pro Tiefe, damit pro Knoten nichts angelegt wird
+    static PlacementList lists[MAX_DEPTH + 1];
+    PlacementList *list = &lists[depth];
+    uint64_t nodes = 0;
+
+    for (int use_hold = 0; use_hold <= hold_moves; use_hold++)
+    {
+        GameState start = *g;
+        if (use_hold)
+        {
+            if (!g->can_hold || !(game_step(&start, INPUT_HOLD, 0) & GAME_EVENT_MOVED))
+                break;
+        }
+
+        generate(&start, list);
+        if (depth == 1 && !divide)
+        {
+            nodes += list->count;
+            continue;
+        }
+
+        for (int i = 0; i < list->count; i++)
+        {
+            GameState child = start;
+            place(&child, &list->piece[i]);
+            uint64_t count = depth == 1 ? 1 : child.game_over ? 0 : perft(&child, depth - 1);
+            if (divide)
+            {
+                const Tetromino *t = &list->piece[i];
+                printf("%s%c r%d x%d y%d: %llu\n", use_hold ? "hold " : "", "IOTSZJL"[t->type],
+                       t->rotation & 3, t->x, t->y, (unsigned long long)count);
+            }
+            nodes += count;
+        }
+    }
+
+    return nodes;
+}
+
+static uint64_t perft(const GameState *g, int depth)
+{
+    return for_each_move(g, depth, 0);
+}
+
+// Spielfeld aus einer Textdatei: '#' oder 'X' belegt, alles andere frei,
+// die letzte Zeile der Datei ist die unterste des Spielfelds
+static int load_board(GameState *g, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return 0;
+
+    char lines[HEIGHT][256];
+    int count = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+        // Ältere Zeilen rutschen raus, es zählen die untersten HEIGHT
+        if (count == HEIGHT)
+        {
+            memmove(lines[0], lines[1], sizeof(lines[0]) * (HEIGHT - 1));
+            count--;
+        }
+        memcpy(lines[count++], line, sizeof(line));
+    }
+    fclose(f);
+
+    for (int i = 0; i < count; i++)
+    {
+        int y = HEIGHT - count + i;
+        for (int x = 0; x < WIDTH && lines[i][x] && lines[i][x] != '\n'; x++)
+        {
+            if (lines[i][x] == '#' || lines[i][x] == 'X')
+            {
+                g->board_rows[y] |= 1u << x;
+                g->board[y][x] = 1;
+            }
+        }
+    }
+    update_derived(g);
+    return 1;
+}
+
+// Steinfolge aus Buchstaben (IOTSZJL): der erste ist der aktuelle Stein,
+// danach die Vorschau; dahinter geht es mit Bags aus dem Seed weiter
+static int set_queue(GameState *g, const char *letters)
+{
+    static const char names[] = "IOTSZJL";
+    int n = strlen(letters);
+    if (n == 0 || n > MAX_LOOKAHEAD)
+        return 0;
+
+    game_set_lookahead(g, n > 1 ? n - 1 : 1);
+    for (int i = 0; i < n; i++)
+    {
+        const char *type = strchr(names, letters[i]);
+        if (!type)
+            return 0;
+        if (i == 0)
+            g->current = spawn_tetromino(type - names);
+        else
+            g->queue[(g->queue_head + i - 1) & (PIECE_QUEUE_SIZE - 1)] = type - names;
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    int depth = 1;
+    int divide = 0;
+    const char *board_path = NULL;
+    const char *queue = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--depth=", 8) == 0)
+            depth = atoi(argv[i] + 8);
+        else if (strcmp(argv[i], "--divide") == 0)
+            divide = 1;
+        else if (strcmp(argv[i], "--no-hold") == 0)
+            hold_moves = 0;
+        else if (strncmp(argv[i], "--board=", 8) == 0)
+            board_path = argv[i] + 8;
+        else if (strncmp(argv[i], "--queue=", 8) == 0)
+            queue = argv[i] + 8;
+    }
+    if (depth < 1 || depth > MAX_DEPTH)
+    {
+        fprintf(stderr, "Tiefe muss zwischen 1 und %d liegen\n", MAX_DEPTH);
+        return 1;
+    }
+
+    GameState g;
+    game_init(&g, &rules_ncurses, seed_from_args(argc, argv));
+    if (board_path && !load_board(&g, board_path))
+    {
+        fprintf(stderr, "Spielfeld %s nicht lesbar\n", board_path);
+        return 1;
+    }
+    if (queue && !set_queue(&g, queue))
+    {
+        fprintf(stderr, "Steinfolge %s ungültig (nur IOTSZJL)\n", queue);
+        return 1;
+    }
+
+    if (divide)
+    {
+        uint64_t nodes = for_each_move(&g, depth, 1);
+        printf("\nGesamt: %llu\n", (unsigned long long)nodes);
+        return 0;
+    }
+
+    printf("Seed:  %llu\n", (unsigned long long)g.seed);
+    printf("%-6s %14s %10s %14s\n", "Tiefe", "Knoten", "Zeit s", "Knoten/s");
+    for (int d = 1; d <= depth; d++)
+    {
+        int64_t start = time_now_us();
+        uint64_t nodes = perft(&g, d);
+        double seconds = (time_now_us() - start) / 1e6;
+        printf("%-6d %14llu %10.3f %14.0f\n", d, (unsigned long long)nodes, seconds,
+               seconds > 0 ? nodes / seconds : 0);
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include "tetris_render_ansi.h"
+
+// Farben für Terminal
+#define COLOR_RESET "\033[0m"
+#define COLOR_CYAN "\033[36m"
+#define COLOR_YELLOW "\033[33m"
+#define COLOR_PURPLE "\033[35m"
+#define COLOR_GREEN "\033[32m"
+#define COLOR_RED "\033[31m"
+#define COLOR_BLUE "\033[34m"
+#define COLOR_ORANGE "\033[38;5;208m"
+#define COLOR_GRAY "\033[90m"
+
+static const char *colors[7] = {
+    COLOR_CYAN,   // I
+    COLOR_YELLOW, // O
+    COLOR_PURPLE, // T
+    COLOR_GREEN,  // S
+    COLOR_RED,    // Z
+    COLOR_BLUE,   // J
+    COLOR_ORANGE  // L
+};
+
+// Bildschirmzeilen (1-basiert, für Cursor-Adressierung)
+#define SCORE_ROW 6
+#define BOARD_ROW 8
+#define BOARD_COL 3
+
+// Frame-Puffer: ein ganzer Frame wird hier zusammengebaut und mit einem
+// einzigen write() ausgegeben
+#define FRAME_BUF_SIZE 16384
+static char frame_buf[FRAME_BUF_SIZE];
+static int frame_len = 0;
+static int output_fd = STDOUT_FILENO;
+
+// Zuletzt ausgegebener Zustand, gegen den der nächste Frame verglichen wird
+static int drawn_cells[HEIGHT][WIDTH];
+static int drawn_score, drawn_level, drawn_lines;
+static int frame_valid = 0; // 0 = nächster Frame zeichnet alles neu
+
+// Zustand des Terminals während des Zusammenbauens
+static const char *frame_color = NULL; // NULL = Standardfarbe
+static int cursor_row = 0, cursor_col = 0;
+
+static void frame_puts(const char *str)
+{
+    int n = strlen(str);
+    if (frame_len + n <= FRAME_BUF_SIZE)
+    {
+        memcpy(frame_buf + frame_len, str, n);
+        frame_len += n;
+    }
+}
+
+static void frame_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(frame_buf + frame_len, FRAME_BUF_SIZE - frame_len, fmt, args);
+    va_end(args);
+    if (n > 0 && frame_len + n < FRAME_BUF_SIZE)
+        frame_len += n;
+}
+
+static void frame_move(int row, int col)
+{
+    if (row != cursor_row || col != cursor_col)
+    {
+        frame_printf("\033[%d;%dH", row, col);
+        cursor_row = row;
+        cursor_col = col;
+    }
+}
+
+// Farbe nur wechseln, wenn sie sich wirklich ändert
+static void frame_set_color(const char *color)
+{
+    if (color != frame_color)
+    {
+        frame_puts(color ? color : COLOR_RESET);
+        frame_color = color;
+    }
+}
+
+static void frame_flush()
+{
+    int written = 0;
+    while (written < frame_len)
+    {
+        ssize_t n = write(output_fd, frame_buf + written, frame_len - written);
+        if (n <= 0)
+            break;
+        written += n;
+    }
+    frame_len = 0;
+}
+
+// Statischer Teil: Titel, Rahmen und Steuerung
+static void compose_chrome()
+{
+    frame_puts("\033[2J\033[H");
+    frame_puts("\n");
+    frame_puts("  ╔══════════════════════════════════════╗\n");
+    frame_puts("  ║              TETRIS GAME             ║\n");
+    frame_puts("  ╚══════════════════════════════════════╝\n");
+
+    frame_printf("\033[%d;1H  ╔", BOARD_ROW);
+    for (int i = 0; i < WIDTH * 2; i++)
+        frame_puts("═");
+    frame_puts("╗");
+
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        frame_printf("\033[%d;1H  ║\033[%dC║", BOARD_ROW + 1 + i, WIDTH * 2);
+    }
+
+    frame_printf("\033[%d;1H  ╚", BOARD_ROW + HEIGHT + 1);
+    for (int i = 0; i < WIDTH * 2; i++)
+        frame_puts("═");
+    frame_puts("╝\n\n");
+
+    frame_puts("  Steuerung:\n");
+    frame_puts("  ← → : Bewegen    ↓ : Schneller    ↑/Z : Drehen    Q : Beenden\n");
+
+    // Cursorposition ist danach unbekannt
+    cursor_row = cursor_col = 0;
+
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        for (int j = 0; j < WIDTH; j++)
+        {
+            drawn_cells[i][j] = -1;
+        }
+    }
+    drawn_score = drawn_level = drawn_lines = -1;
+}
+
+void ansi_set_output(int fd)
+{
+    output_fd = fd;
+    frame_valid = 0;
+}
+
+void ansi_invalidate()
+{
+    frame_valid = 0;
+}
+
+int ansi_compose(const GameState *g)
+{
+    if (!frame_valid)
+    {
+        compose_chrome();
+        frame_valid = 1;
+    }
+
+    if (g->score != drawn_score || g->level != drawn_level || g->lines_cleared != drawn_lines)
+    {
+        frame_move(SCORE_ROW, 1);
+        frame_set_color(NULL);
+        frame_printf("  Score: %d    Level: %d    Lines: %d\033[K", g->score, g->level, g->lines_cleared);
+        cursor_row = cursor_col = 0;
+        drawn_score = g->score;
+        drawn_level = g->level;
+        drawn_lines = g->lines_cleared;
+    }
+
+    int display[HEIGHT][WIDTH];
+    game_display(g, display);
+
+    // Nur geänderte Zellen ausgeben; benachbarte Zellen brauchen keine
+    // neue Cursorposition
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        for (int j = 0; j < WIDTH; j++)
+        {
+            int value = display[i][j];
+            if (value == drawn_cells[i][j])
+                continue;
+
+            frame_move(BOARD_ROW + 1 + i, BOARD_COL + 1 + j * 2);
+            if (value >= GHOST_CELL)
+            {
+                frame_set_color(colors[value - GHOST_CELL]);
+                frame_puts("▒▒");
+            }
+            else if (value)
+            {
+                frame_set_color(colors[value - 1]);
+                frame_puts("██");
+            }
+            else if ((i + j) % 2 == 0)
+            {
+                frame_set_color(COLOR_GRAY);
+                frame_puts("░░");
+            }
+            else
+            {
+                frame_puts("  "); // Leerzeichen brauchen keine Farbe
+            }
+            cursor_col += 2;
+            drawn_cells[i][j] = value;
+        }
+    }
+
+    if (frame_len > 0)
+        frame_set_color(NULL);
+    return frame_len;
+}
+
+void ansi_flush()
+{
+    if (frame_len > 0)
+        frame_flush();
+}
+
+void ansi_draw_board(const GameState *g)
+{
+    ansi_compose(g);
+    ansi_flush();
+}
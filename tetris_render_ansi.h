@@ -0,0 +1,23 @@
+#ifndef TETRIS_RENDER_ANSI_H
+#define TETRIS_RENDER_ANSI_H
+
+#include "tetris_core.h"
+
+// Darstellung mit ANSI Escape-Sequenzen ohne ncurses. Jeder Frame wird im
+// Speicher zusammengebaut, enthält nur geänderte Zellen und geht mit einem
+// einzigen write() raus.
+
+// Ausgabe auf fd umlenken (Standard: STDOUT_FILENO); zeichnet danach alles neu
+void ansi_set_output(int fd);
+
+// Beim nächsten Frame alles neu zeichnen
+void ansi_invalidate();
+
+void ansi_draw_board(const GameState *g);
+
+// ansi_draw_board in zwei Schritten (für Zeitmessungen): Frame im Speicher
+// zusammenbauen (gibt seine Länge zurück), dann mit einem write() ausgeben
+int ansi_compose(const GameState *g);
+void ansi_flush();
+
+#endif
@@ -0,0 +1,235 @@
+#include <ncurses.h>
+#include "tetris_render_curses.h"
+
+// Farben (ncurses color pairs)
+#define COLOR_PAIR_I 1
+#define COLOR_PAIR_O 2
+#define COLOR_PAIR_T 3
+#define COLOR_PAIR_S 4
+#define COLOR_PAIR_Z 5
+#define COLOR_PAIR_J 6
+#define COLOR_PAIR_L 7
+
+void curses_init_colors()
+{
+    start_color();
+    // Farbige Blöcke mit schwarzem Hintergrund
+    init_pair(COLOR_PAIR_I, COLOR_BLACK, COLOR_CYAN);    // I - Cyan
+    init_pair(COLOR_PAIR_O, COLOR_BLACK, COLOR_YELLOW);  // O - Gelb
+    init_pair(COLOR_PAIR_T, COLOR_BLACK, COLOR_MAGENTA); // T - Magenta
+    init_pair(COLOR_PAIR_S, COLOR_BLACK, COLOR_GREEN);   // S - Grün
+    init_pair(COLOR_PAIR_Z, COLOR_BLACK, COLOR_RED);     // Z - Rot
+    init_pair(COLOR_PAIR_J, COLOR_BLACK, COLOR_BLUE);    // J - Blau
+    init_pair(COLOR_PAIR_L, COLOR_BLACK, COLOR_WHITE);   // L - Weiß
+    init_pair(8, COLOR_WHITE, COLOR_BLACK);              // Für Rahmen
+    init_pair(9, COLOR_BLACK, COLOR_BLACK);              // Dunkles Schachbrett
+}
+
+// Layout: Spielfeld, HOLD Box links daneben, NEXT Boxen rechts
+#define BOARD_Y 4
+#define BOARD_X 2
+#define HOLD_X (BOARD_X + WIDTH * 2 + 5)
+#define NEXT_X (HOLD_X + 15)
+
+// Was zuletzt auf dem Bildschirm gezeichnet wurde. draw_board vergleicht
+// dagegen und zeichnet nur geänderte Zellen, Zahlen und Vorschauboxen neu.
+static int drawn_cells[HEIGHT][WIDTH];
+static int drawn_score, drawn_level, drawn_lines;
+static int drawn_hold;
+static int drawn_next[NEXT_PIECES];
+static int chrome_drawn = 0; // 0 = alles neu zeichnen (Start, Terminalgröße geändert)
+
+static void draw_box(int y, int x)
+{
+    mvaddch(y, x, '+');
+    for (int i = 0; i < 10; i++)
+        addch('-');
+    addch('+');
+
+    for (int i = 0; i < 4; i++)
+    {
+        mvaddch(y + 1 + i, x, '|');
+        mvaddch(y + 1 + i, x + 11, '|');
+    }
+
+    mvaddch(y + 5, x, '+');
+    for (int i = 0; i < 10; i++)
+        addch('-');
+    addch('+');
+}
+
+// Statischer Rahmen: Titel, Hilfe, Spielfeldrand und Boxen
+static void draw_chrome()
+{
+    clear();
+
+    mvprintw(0, 2, "=== TETRIS ===");
+    mvprintw(2, 2, "<- -> : Bewegen  |  v : Runter  |  ^/W : Hard Drop  |  R/Z : Drehen  |  E : Hold  |  Q : Beenden");
+
+    attron(COLOR_PAIR(8) | A_BOLD);
+    mvaddch(BOARD_Y, BOARD_X, '+');
+    for (int i = 0; i < WIDTH * 2; i++)
+        addch('=');
+    addch('+');
+
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        mvaddch(BOARD_Y + i + 1, BOARD_X, '|');
+        mvaddch(BOARD_Y + i + 1, BOARD_X + WIDTH * 2 + 1, '|');
+    }
+
+    mvaddch(BOARD_Y + HEIGHT + 1, BOARD_X, '+');
+    for (int i = 0; i < WIDTH * 2; i++)
+        addch('=');
+    addch('+');
+    attroff(COLOR_PAIR(8) | A_BOLD);
+
+    mvprintw(BOARD_Y, HOLD_X, "HOLD (E):");
+    draw_box(BOARD_Y + 1, HOLD_X);
+
+    mvprintw(BOARD_Y, NEXT_X, "NEXT:");
+    for (int n = 0; n < NEXT_PIECES; n++)
+    {
+        draw_box(BOARD_Y + 1 + n * 5, NEXT_X);
+    }
+
+    // Alles Dynamische als ungültig markieren
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        for (int j = 0; j < WIDTH; j++)
+        {
+            drawn_cells[i][j] = -1;
+        }
+    }
+    drawn_score = drawn_level = drawn_lines = -1;
+    drawn_hold = -2;
+    for (int n = 0; n < NEXT_PIECES; n++)
+    {
+        drawn_next[n] = -2;
+    }
+}
+
+static void draw_cell(int i, int j, int value)
+{
+    move(BOARD_Y + i + 1, BOARD_X + 1 + j * 2);
+    if (value >= GHOST_CELL)
+    {
+        attron(COLOR_PAIR(8) | A_DIM);
+        addstr("[]");
+        attroff(COLOR_PAIR(8) | A_DIM);
+    }
+    else if (value)
+    {
+        // Farbige Blöcke mit fettem Text
+        attron(COLOR_PAIR(value) | A_BOLD);
+        addstr("  "); // Volle Blöcke
+        attroff(COLOR_PAIR(value) | A_BOLD);
+    }
+    else if (i % 2 == 0 && j % 2 == 0)
+    {
+        // Raster mit einfachen Punkten (jede 2. Zeile und Spalte)
+        attron(A_DIM);
+        addstr(". ");
+        attroff(A_DIM);
+    }
+    else
+    {
+        addstr("  ");
+    }
+}
+
+// Inneres einer Vorschaubox leeren und Stein (oder nichts bei -1) zeichnen
+static void draw_preview(int y, int x, int piece)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        mvaddstr(y + i, x + 1, "          ");
+    }
+
+    if (piece >= 0)
+    {
+        const PieceRotation *p = &piece_table[piece][0];
+        attron(COLOR_PAIR(piece + 1) | A_BOLD);
+        for (int k = 0; k < 4; k++)
+        {
+            mvaddstr(y + p->cells[k][0], x + 2 + p->cells[k][1] * 2, "  ");
+        }
+        attroff(COLOR_PAIR(piece + 1) | A_BOLD);
+    }
+}
+
+void curses_invalidate()
+{
+    chrome_drawn = 0;
+}
+
+int curses_compose(const GameState *g)
+{
+    int changed = 0;
+
+    if (!chrome_drawn)
+    {
+        draw_chrome();
+        chrome_drawn = 1;
+        changed = 1;
+    }
+
+    if (g->score != drawn_score || g->level != drawn_level || g->lines_cleared != drawn_lines)
+    {
+        mvprintw(1, 2, "Score: %d  Level: %d  Lines: %d", g->score, g->level, g->lines_cleared);
+        clrtoeol();
+        drawn_score = g->score;
+        drawn_level = g->level;
+        drawn_lines = g->lines_cleared;
+        changed = 1;
+    }
+
+    // Temporäres Board für Anzeige
+    int display[HEIGHT][WIDTH];
+    game_display(g, display);
+
+    // Nur Zellen zeichnen, die sich seit dem letzten Frame geändert haben
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        for (int j = 0; j < WIDTH; j++)
+        {
+            if (display[i][j] != drawn_cells[i][j])
+            {
+                draw_cell(i, j, display[i][j]);
+                drawn_cells[i][j] = display[i][j];
+                changed = 1;
+            }
+        }
+    }
+
+    if (g->hold_piece != drawn_hold)
+    {
+        draw_preview(BOARD_Y + 2, HOLD_X, g->hold_piece);
+        drawn_hold = g->hold_piece;
+        changed = 1;
+    }
+
+    for (int n = 0; n < NEXT_PIECES; n++)
+    {
+        int piece = peek_piece(g, n);
+        if (piece != drawn_next[n])
+        {
+            draw_preview(BOARD_Y + 2 + n * 5, NEXT_X, piece);
+            drawn_next[n] = piece;
+            changed = 1;
+        }
+    }
+
+    return changed;
+}
+
+void curses_flush()
+{
+    refresh();
+}
+
+void curses_draw_board(const GameState *g)
+{
+    if (curses_compose(g))
+        curses_flush();
+}
@@ -0,0 +1,23 @@
+#ifndef TETRIS_RENDER_CURSES_H
+#define TETRIS_RENDER_CURSES_H
+
+#include "tetris_core.h"
+
+// ncurses Darstellung des Spielfelds. Merkt sich, was schon auf dem
+// Bildschirm steht, und zeichnet nur Änderungen; initscr() und Co. macht
+// der Aufrufer.
+
+void curses_init_colors();
+
+// Beim nächsten Frame alles neu zeichnen (z.B. nach KEY_RESIZE)
+void curses_invalidate();
+
+// Zeichnet nur, was sich geändert hat; refresh() nur, wenn nötig
+void curses_draw_board(const GameState *g);
+
+// curses_draw_board in zwei Schritten (für Zeitmessungen): Änderungen in
+// stdscr eintragen, gibt 1 zurück, wenn danach refresh() nötig ist
+int curses_compose(const GameState *g);
+void curses_flush();
+
+#endif
@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "tetris_render_thread.h"
+#include "tetris_stats.h"
+#include "tetris_trace.h"
+
+// Bit im Index des mittleren Puffers: enthält einen noch nicht gezeichneten
+// Stand
+#define FRAME_FRESH 4
+
+typedef struct
+{
+    GameState game;
+    uint64_t seq;       // Laufende Nummer des Frames, ab 1
+    int64_t input_ns;   // Älteste Taste, die noch auf keinem Bildschirm war
+    uint64_t input_seq; // Erster Frame mit dieser Taste
+} RenderFrame;
+
+// Dreifachpuffer: back gehört der Spielschleife, front dem Render-Thread,
+// middle wird zwischen beiden per atomic_exchange getauscht. Keiner der
+// beiden wartet je auf den anderen, um an einen Puffer zu kommen.
+struct RenderThread
+{
+    pthread_t thread;
+    Renderer renderer;
+
+    RenderFrame frames[3];
+    int back;
+    int front;
+    atomic_int middle; // Index | FRAME_FRESH
+
+    // Nur die Spielschleife: Frames werden übersprungen, also bleibt eine
+    // Taste in allen Frames stehen, bis einer mit ihr gezeichnet wurde
+    uint64_t published;
+    int64_t oldest_ns;
+    uint64_t oldest_seq;
+
+    atomic_uint_fast64_t shown_seq; // Zuletzt gezeichneter Frame
+    uint64_t measured_seq;          // Nur der Render-Thread
+
+    atomic_int invalidate;
+
+    // Nur zum Aufwecken des Render-Threads
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int stop;
+};
+
+static void draw_frame(RenderThread *r, const RenderFrame *f)
+{
+    int64_t t_compose = trace_now();
+    int changed = r->renderer.compose(&f->game);
+    int64_t t_flush = trace_now();
+    stats_record(STATS_COMPOSE, t_flush - t_compose);
+    trace_complete("draw_board", t_compose, t_flush);
+
+    if (changed)
+    {
+        r->renderer.flush();
+        int64_t t_done = trace_now();
+        stats_record(STATS_FLUSH, t_done - t_flush);
+        trace_complete(r->renderer.flush_name, t_flush, t_done);
+        // Jede Taste nur beim ersten Frame zählen, der sie zeigt
+        if (f->input_ns && f->input_seq > r->measured_seq)
+        {
+            stats_record(STATS_LATENCY, t_done - f->input_ns);
+            r->measured_seq = f->input_seq;
+        }
+    }
+}
+
+static int has_work(RenderThread *r)
+{
+    return (atomic_load(&r->middle) & FRAME_FRESH) || atomic_load(&r->invalidate);
+}
+
+static void *render_main(void *arg)
+{
+    RenderThread *r = arg;
+    int have_frame = 0;
+
+    pthread_mutex_lock(&r->lock);
+    while (1)
+    {
+        while (!r->stop && !has_work(r))
+            pthread_cond_wait(&r->wake, &r->lock);
+        if (!has_work(r))
+            break; // stop und alles gezeichnet
+        pthread_mutex_unlock(&r->lock);
+
+        if (atomic_exchange(&r->invalidate, 0))
+            r->renderer.invalidate();
+
+        if (atomic_load(&r->middle) & FRAME_FRESH)
+        {
+            r->front = atomic_exchange(&r->middle, r->front) & ~FRAME_FRESH;
+            atomic_store(&r->shown_seq, r->frames[r->front].seq);
+            have_frame = 1;
+        }
+        if (have_frame)
+            draw_frame(r, &r->frames[r->front]);
+
+        pthread_mutex_lock(&r->lock);
+    }
+    pthread_mutex_unlock(&r->lock);
+    return NULL;
+}
+
+static void wake(RenderThread *r)
+{
+    pthread_mutex_lock(&r->lock);
+    pthread_cond_signal(&r->wake);
+    pthread_mutex_unlock(&r->lock);
+}
+
+RenderThread *render_thread_start(const Renderer *renderer)
+{
+    RenderThread *r = calloc(1, sizeof(RenderThread));
+    if (!r)
+        return NULL;
+
+    r->renderer = *renderer;
+    r->back = 0;
+    atomic_init(&r->middle, 1);
+    r->front = 2;
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->wake, NULL);
+
+    if (pthread_create(&r->thread, NULL, render_main, r) != 0)
+    {
+        pthread_mutex_destroy(&r->lock);
+        pthread_cond_destroy(&r->wake);
+        free(r);
+        return NULL;
+    }
+    return r;
+}
+
+void render_thread_stop(RenderThread *r)
+{
+    if (!r)
+        return;
+
+    pthread_mutex_lock(&r->lock);
+    r->stop = 1;
+    pthread_cond_signal(&r->wake);
+    pthread_mutex_unlock(&r->lock);
+    pthread_join(r->thread, NULL);
+
+    pthread_mutex_destroy(&r->lock);
+    pthread_cond_destroy(&r->wake);
+    free(r);
+}
+
+void render_publish(RenderThread *r, const GameState *g, int64_t input_ns)
+{
+    uint64_t seq = ++r->published;
+
+    if (r->oldest_ns && atomic_load(&r->shown_seq) >= r->oldest_seq)
+        r->oldest_ns = 0;
+    if (!r->oldest_ns && input_ns)
+    {
+        r->oldest_ns = input_ns;
+        r->oldest_seq = seq;
+    }
+
+    RenderFrame *f = &r->frames[r->back];
+    f->game = *g;
+    f->seq = seq;
+    f->input_ns = r->oldest_ns;
+    f->input_seq = r->oldest_seq;
+
+    r->back = atomic_exchange(&r->middle, r->back | FRAME_FRESH) & ~FRAME_FRESH;
+    wake(r);
+}
+
+void render_invalidate(RenderThread *r)
+{
+    atomic_store(&r->invalidate, 1);
+    wake(r);
+}
@@ -0,0 +1,39 @@
+#ifndef TETRIS_RENDER_THREAD_H
+#define TETRIS_RENDER_THREAD_H
+
+#include <stdint.h>
+#include "tetris_core.h"
+
+// Darstellung in einem eigenen Thread. Die Spielschleife legt nach jeder
+// Änderung eine Kopie des Spielstands in einen Dreifachpuffer und läuft
+// sofort weiter; der Render-Thread zeichnet jeweils den neuesten Stand.
+// Ist das Terminal langsamer als das Spiel, werden Zwischenstände
+// übersprungen, Schwerkraft und Eingaben warten nie auf die Ausgabe.
+
+// Renderer, den der Thread benutzt. Alle Aufrufe kommen aus dem
+// Render-Thread; das Frontend darf solange selbst nichts zeichnen.
+typedef struct
+{
+    int (*compose)(const GameState *g); // != 0, wenn flush nötig ist
+    void (*flush)();
+    void (*invalidate)();   // Beim nächsten Frame alles neu zeichnen
+    const char *flush_name; // Name der Ausgabe im Trace
+} Renderer;
+
+typedef struct RenderThread RenderThread;
+
+// NULL bei Fehlern
+RenderThread *render_thread_start(const Renderer *renderer);
+
+// Zeichnet noch den zuletzt übergebenen Stand und beendet den Thread
+void render_thread_stop(RenderThread *r);
+
+// Neuen Stand übergeben; blockiert nicht. input_ns ist der Zeitpunkt
+// (stats_now), zu dem die älteste darin enthaltene Taste gelesen wurde,
+// 0 = keine; daraus wird STATS_LATENCY.
+void render_publish(RenderThread *r, const GameState *g, int64_t input_ns);
+
+// Beim nächsten Frame alles neu zeichnen (z.B. nach SIGWINCH)
+void render_invalidate(RenderThread *r);
+
+#endif
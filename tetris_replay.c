@@ -0,0 +1,429 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tetris_replay.h"
+
+// Eingaben werden in Blöcken gesammelt; volle Blöcke (oder spätestens nach
+// REPLAY_FLUSH_MS Spielzeit) bekommt der Schreib-Thread. Geschriebene
+// Blöcke kommen zurück in eine Freiliste, im Dauerbetrieb wird also nichts
+// mehr angelegt.
+#define REPLAY_CHUNK_SIZE 4096
+#define REPLAY_FLUSH_MS 1000
+
+// Endet die Aufnahme ohne Game Over (abgebrochen), wird höchstens so lange
+// ohne Eingaben weitergerechnet
+#define REPLAY_TAIL_MS (10 * 60 * 1000)
+
+typedef struct ReplayChunk
+{
+    struct ReplayChunk *next;
+    int len;
+    uint8_t data[REPLAY_CHUNK_SIZE];
+} ReplayChunk;
+
+struct ReplayWriter
+{
+    FILE *file;
+    pthread_t thread;
+
+    // Nur von der Spielschleife benutzt
+    ReplayChunk *active;
+    int64_t last_ms;    // Zeit der letzten Eingabe
+    int64_t handoff_ms; // Zeit der letzten Übergabe an den Thread
+
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    ReplayChunk *pending_head, *pending_tail; // Warten aufs Schreiben
+    ReplayChunk *free_list;
+    int stop;
+};
+
+int replay_put_varint(uint8_t *out, uint64_t value)
+{
+    int n = 0;
+    while (value >= 0x80)
+    {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static void *writer_main(void *arg)
+{
+    ReplayWriter *w = arg;
+
+    pthread_mutex_lock(&w->lock);
+    while (1)
+    {
+        while (!w->pending_head && !w->stop)
+            pthread_cond_wait(&w->ready, &w->lock);
+
+        ReplayChunk *list = w->pending_head;
+        w->pending_head = w->pending_tail = NULL;
+        if (!list && w->stop)
+            break;
+        pthread_mutex_unlock(&w->lock);
+
+        ReplayChunk *last = list;
+        for (ReplayChunk *c = list; c; c = c->next)
+        {
+            fwrite(c->data, 1, c->len, w->file);
+            c->len = 0;
+            last = c;
+        }
+        fflush(w->file);
+
+        pthread_mutex_lock(&w->lock);
+        last->next = w->free_list;
+        w->free_list = list;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+// Aktiven Block dem Thread übergeben und einen leeren holen
+static void handoff(ReplayWriter *w)
+{
+    ReplayChunk *full = w->active;
+    full->next = NULL;
+
+    pthread_mutex_lock(&w->lock);
+    if (w->pending_tail)
+        w->pending_tail->next = full;
+    else
+        w->pending_head = full;
+    w->pending_tail = full;
+
+    ReplayChunk *empty = w->free_list;
+    if (empty)
+        w->free_list = empty->next;
+    pthread_cond_signal(&w->ready);
+    pthread_mutex_unlock(&w->lock);
+
+    if (!empty)
+        empty = malloc(sizeof(ReplayChunk));
+    // Ohne Speicher gehen Eingaben verloren, das Spiel läuft aber weiter
+    if (empty)
+        empty->len = 0;
+    w->active = empty;
+}
+
+ReplayWriter *replay_open(const char *path, const GameState *g)
+{
+    ReplayWriter *w = calloc(1, sizeof(ReplayWriter));
+    if (!w)
+        return NULL;
+
+    w->file = fopen(path, "wb");
+    w->active = malloc(sizeof(ReplayChunk));
+    if (!w->file || !w->active)
+    {
+        if (w->file)
+            fclose(w->file);
+        free(w->active);
+        free(w);
+        return NULL;
+    }
+
+    // Kopf
+    uint8_t *out = w->active->data;
+    int n = 0;
+    memcpy(out, REPLAY_MAGIC, 4);
+    n += 4;
+    out[n++] = REPLAY_VERSION;
+    for (int i = 0; i < 8; i++)
+        out[n++] = (uint8_t)(g->seed >> (8 * i));
+    n += replay_put_varint(out + n, g->rules.start_speed);
+    n += replay_put_varint(out + n, g->rules.speed_step);
+    n += replay_put_varint(out + n, g->rules.min_speed);
+    n += replay_put_varint(out + n, g->rules.lines_per_level);
+    w->active->len = n;
+
+    w->last_ms = g->time_ms;
+    w->handoff_ms = g->time_ms;
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->ready, NULL);
+    if (pthread_create(&w->thread, NULL, writer_main, w) != 0)
+    {
+        pthread_cond_destroy(&w->ready);
+        pthread_mutex_destroy(&w->lock);
+        fclose(w->file);
+        free(w->active);
+        free(w);
+        return NULL;
+    }
+
+    // Den Kopf sofort schreiben, damit auch abgebrochene Aufnahmen lesbar sind
+    handoff(w);
+    return w;
+}
+
+void replay_record(ReplayWriter *w, const GameState *g, GameInput input)
+{
+    if (!w || !w->active || input == INPUT_NONE)
+        return;
+
+    ReplayChunk *c = w->active;
+    c->len += replay_put_varint(c->data + c->len, (uint64_t)(g->time_ms - w->last_ms));
+    c->data[c->len++] = (uint8_t)input;
+    w->last_ms = g->time_ms;
+
+    if (c->len > REPLAY_CHUNK_SIZE - REPLAY_MAX_RECORD || g->time_ms - w->handoff_ms >= REPLAY_FLUSH_MS)
+    {
+        handoff(w);
+        w->handoff_ms = g->time_ms;
+    }
+}
+
+void replay_close(ReplayWriter *w)
+{
+    if (!w)
+        return;
+
+    if (w->active && w->active->len > 0)
+        handoff(w);
+
+    pthread_mutex_lock(&w->lock);
+    w->stop = 1;
+    pthread_cond_signal(&w->ready);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+
+    while (w->free_list)
+    {
+        ReplayChunk *next = w->free_list->next;
+        free(w->free_list);
+        w->free_list = next;
+    }
+    free(w->active);
+
+    fclose(w->file);
+    pthread_cond_destroy(&w->ready);
+    pthread_mutex_destroy(&w->lock);
+    free(w);
+}
+
+int replay_get_varint(const uint8_t *data, size_t size, size_t *pos, uint64_t *value)
+{
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (*pos >= size)
+            return 0;
+        uint8_t b = data[(*pos)++];
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+            *value = v;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Kopf lesen; 0, wenn es keine (lesbare) Replay Datei ist
+static int parse_header(ReplayPlayer *p)
+{
+    size_t pos = 0;
+    if (p->size < 13 || memcmp(p->data, REPLAY_MAGIC, 4) != 0 || p->data[4] != REPLAY_VERSION)
+        return 0;
+    pos = 5;
+
+    p->seed = 0;
+    for (int i = 0; i < 8; i++)
+        p->seed |= (uint64_t)p->data[pos++] << (8 * i);
+
+    uint64_t v[4];
+    for (int i = 0; i < 4; i++)
+    {
+        if (!replay_get_varint(p->data, p->size, &pos, &v[i]) || v[i] > INT_MAX)
+            return 0;
+    }
+    p->rules.start_speed = (int)v[0];
+    p->rules.speed_step = (int)v[1];
+    p->rules.min_speed = (int)v[2];
+    p->rules.lines_per_level = (int)v[3];
+    if (p->rules.start_speed <= 0 || p->rules.min_speed <= 0 || p->rules.lines_per_level <= 0)
+        return 0;
+
+    p->body = pos;
+    return 1;
+}
+
+// Nächsten Eintrag lesen, ohne ihn anzuwenden; 0 am Ende der Datei (auch
+// bei einem abgeschnittenen letzten Eintrag)
+static int peek_record(const ReplayPlayer *p, int64_t *at, GameInput *input, size_t *next)
+{
+    size_t pos = p->pos;
+    uint64_t delta;
+    if (!replay_get_varint(p->data, p->size, &pos, &delta) || pos >= p->size)
+        return 0;
+    if (delta > INT_MAX)
+        return 0;
+
+    *at = p->last_ms + (int64_t)delta;
+    *input = (GameInput)p->data[pos];
+    *next = pos + 1;
+    return 1;
+}
+
+int replay_player_done(const ReplayPlayer *p)
+{
+    int64_t at;
+    GameInput input;
+    size_t next;
+    return p->game.game_over || !peek_record(p, &at, &input, &next);
+}
+
+int replay_player_advance(ReplayPlayer *p, int64_t time_ms)
+{
+    int events = 0;
+    if (time_ms > p->end_ms)
+        time_ms = p->end_ms;
+
+    int64_t at;
+    GameInput input;
+    size_t next;
+    while (!p->game.game_over && peek_record(p, &at, &input, &next) && at <= time_ms)
+    {
+        // Zuerst die Zeit bis zur Eingabe, dann die Eingabe selbst, wie in
+        // der Spielschleife
+        if (at > p->game.time_ms)
+            events |= game_step(&p->game, INPUT_NONE, (int)(at - p->game.time_ms));
+        events |= game_step(&p->game, input, 0);
+        p->pos = next;
+        p->last_ms = at;
+    }
+
+    while (!p->game.game_over && p->game.time_ms < time_ms)
+    {
+        int64_t dt = time_ms - p->game.time_ms;
+        events |= game_step(&p->game, INPUT_NONE, dt > INT_MAX ? INT_MAX : (int)dt);
+    }
+    return events;
+}
+
+static int add_keyframe(ReplayPlayer *p)
+{
+    if ((p->keyframe_count & (p->keyframe_count - 1)) == 0)
+    {
+        // Bei jeder Zweierpotenz verdoppeln
+        int cap = p->keyframe_count ? p->keyframe_count * 2 : 16;
+        ReplayKeyframe *k = realloc(p->keyframes, cap * sizeof(ReplayKeyframe));
+        if (!k)
+            return 0;
+        p->keyframes = k;
+    }
+
+    ReplayKeyframe *k = &p->keyframes[p->keyframe_count++];
+    k->state = p->game;
+    k->pos = p->pos;
+    k->last_ms = p->last_ms;
+    return 1;
+}
+
+static void load_keyframe(ReplayPlayer *p, const ReplayKeyframe *k)
+{
+    p->game = k->state;
+    p->pos = k->pos;
+    p->last_ms = k->last_ms;
+}
+
+int replay_player_open(ReplayPlayer *p, const char *path, int keyframe_ms)
+{
+    memset(p, 0, sizeof(*p));
+    p->keyframe_ms = keyframe_ms > 0 ? keyframe_ms : REPLAY_KEYFRAME_MS;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return 0;
+
+    p->data = map;
+    p->size = st.st_size;
+    if (!parse_header(p))
+    {
+        replay_player_close(p);
+        return 0;
+    }
+
+    game_init(&p->game, &p->rules, p->seed);
+    p->pos = p->body;
+    p->last_ms = 0;
+    p->end_ms = INT64_MAX;
+
+    // Index: einmal ganz durchrechnen und dabei die Keyframes ablegen
+    if (!add_keyframe(p))
+    {
+        replay_player_close(p);
+        return 0;
+    }
+    while (!replay_player_done(p))
+    {
+        replay_player_advance(p, (int64_t)p->keyframe_count * p->keyframe_ms);
+        if (!p->game.game_over && !add_keyframe(p))
+        {
+            replay_player_close(p);
+            return 0;
+        }
+    }
+
+    // Nach der letzten Eingabe läuft die Schwerkraft weiter, bis das Spiel
+    // zu Ende ist
+    replay_player_advance(p, p->game.time_ms + REPLAY_TAIL_MS);
+    p->end_ms = p->game.time_ms;
+
+    for (size_t pos = p->body; pos < p->size;)
+    {
+        uint64_t delta;
+        if (!replay_get_varint(p->data, p->size, &pos, &delta) || pos++ >= p->size)
+            break;
+        p->inputs++;
+    }
+
+    load_keyframe(p, &p->keyframes[0]);
+    return 1;
+}
+
+void replay_player_close(ReplayPlayer *p)
+{
+    if (p->data)
+        munmap((void *)p->data, p->size);
+    free(p->keyframes);
+    memset(p, 0, sizeof(*p));
+}
+
+void replay_player_seek(ReplayPlayer *p, int64_t time_ms)
+{
+    if (time_ms < 0)
+        time_ms = 0;
+
+    int k = (int)(time_ms / p->keyframe_ms);
+    if (k >= p->keyframe_count)
+        k = p->keyframe_count - 1;
+
+    // Vorwärts innerhalb des Intervalls ohne Keyframe
+    if (p->game.time_ms > time_ms || p->game.time_ms < p->keyframes[k].state.time_ms)
+        load_keyframe(p, &p->keyframes[k]);
+    replay_player_advance(p, time_ms);
+}
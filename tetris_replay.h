@@ -0,0 +1,96 @@
+#ifndef TETRIS_REPLAY_H
+#define TETRIS_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tetris_core.h"
+
+// Replay Datei: Kopf mit Seed und Regeln, danach pro Eingabe die seit der
+// letzten Eingabe vergangene Simulationszeit (varint, ms) und ein Byte
+// Aktion. Mit game_init(seed) und denselben Eingaben zu denselben Zeiten
+// entsteht wieder genau dasselbe Spiel.
+//
+//   "TRPL" | Version (1 Byte) | Seed (8 Byte, little endian)
+//   | start_speed, speed_step, min_speed, lines_per_level (je varint)
+//   | { delta_ms (varint) | GameInput (1 Byte) } ...
+
+#define REPLAY_MAGIC "TRPL"
+#define REPLAY_VERSION 2 // 1: Drehen ohne SRS, spielt heute anders ab
+
+// Ein Eintrag ist höchstens so lang (10 Byte varint + Aktion)
+#define REPLAY_MAX_RECORD 11
+
+// varint: 7 Bit pro Byte, höchstes Bit = es folgt noch ein Byte
+int replay_put_varint(uint8_t *out, uint64_t value);
+
+typedef struct ReplayWriter ReplayWriter;
+
+// Datei anlegen und den Kopf für das frisch initialisierte Spiel schreiben.
+// Geschrieben wird von einem eigenen Thread, die Spielschleife wartet nie
+// auf die Platte. NULL, wenn die Datei nicht angelegt werden kann.
+ReplayWriter *replay_open(const char *path, const GameState *g);
+
+// Eingabe aufnehmen, die jetzt (zur Simulationszeit g->time_ms) angewendet
+// wird; vor game_step aufrufen. Kostet im Normalfall nur ein paar Bytes
+// kopieren.
+void replay_record(ReplayWriter *w, const GameState *g, GameInput input);
+
+// Restliche Daten schreiben, Thread beenden und Datei schließen
+void replay_close(ReplayWriter *w);
+
+// Abspielen: die Datei wird per mmap eingeblendet und durch die Spiellogik
+// nachsimuliert. Beim Öffnen wird das ganze Spiel einmal ohne Darstellung
+// durchgerechnet und alle keyframe_ms ein kompletter GameState als Keyframe
+// abgelegt; ein Sprung rechnet dann höchstens ein Intervall nach.
+
+#define REPLAY_KEYFRAME_MS 5000
+
+typedef struct
+{
+    GameState state; // Zustand zu state.time_ms, Eingaben bis dahin angewendet
+    size_t pos;      // Nächster Eintrag in der Datei
+    int64_t last_ms; // Zeit der letzten angewendeten Eingabe
+} ReplayKeyframe;
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+    size_t body; // Erster Eintrag nach dem Kopf
+
+    GameRules rules;
+    uint64_t seed;
+
+    // Aktueller Stand der Wiedergabe
+    GameState game;
+    size_t pos;
+    int64_t last_ms;
+
+    ReplayKeyframe *keyframes;
+    int keyframe_count;
+    int keyframe_ms;
+
+    int64_t end_ms; // Länge des Spiels in Simulationszeit
+    int inputs;     // Anzahl Eingaben in der Datei
+} ReplayPlayer;
+
+// varint ab *pos lesen; 0, wenn die Daten vorher zu Ende sind
+int replay_get_varint(const uint8_t *data, size_t size, size_t *pos, uint64_t *value);
+
+// Datei öffnen, Kopf prüfen und den Index aufbauen; danach steht die
+// Wiedergabe am Anfang. Gibt 0 bei Fehlern zurück.
+int replay_player_open(ReplayPlayer *p, const char *path, int keyframe_ms);
+void replay_player_close(ReplayPlayer *p);
+
+// Bis zur Simulationszeit time_ms vorwärts rechnen, alle Eingaben bis
+// einschließlich time_ms werden angewendet. Gibt die Ereignisse von
+// game_step zurück.
+int replay_player_advance(ReplayPlayer *p, int64_t time_ms);
+
+// Zu einer beliebigen Zeit springen (auch rückwärts)
+void replay_player_seek(ReplayPlayer *p, int64_t time_ms);
+
+// 1, wenn alle Eingaben angewendet sind oder das Spiel vorbei ist
+int replay_player_done(const ReplayPlayer *p);
+
+#endif
@@ -0,0 +1,318 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "tetris_sim.h"
+#include "tetris_time.h"
+
+// Zufälliger Spieler: drehen, verschieben, ab und zu halten, Hard Drop
+static void play_random(GameState *g, const SimOptions *opt)
+{
+    // Eigener Generator für die Entscheidungen, aus dem Spiel abgeleitet,
+    // damit die Steinfolge davon unberührt bleibt
+    Rng rng;
+    rng_seed(&rng, g->rng.state ^ 0x9e3779b97f4a7c15ull);
+
+    while (!g->game_over && (opt->max_pieces == 0 || g->pieces < opt->max_pieces))
+    {
+        if (rng_below(&rng, 8) == 0)
+            game_step(g, INPUT_HOLD, 0);
+
+        int rotations = rng_below(&rng, 4);
+        for (int i = 0; i < rotations; i++)
+            game_step(g, INPUT_ROTATE, 0);
+
+        int shift = (int)rng_below(&rng, 11) - 5;
+        GameInput dir = shift < 0 ? INPUT_LEFT : INPUT_RIGHT;
+        for (int i = 0; i < abs(shift); i++)
+            game_step(g, dir, 0);
+
+        game_step(g, INPUT_HARD_DROP, 0);
+    }
+}
+
+static void play_script(GameState *g, const SimOptions *opt)
+{
+    while (!g->game_over && (opt->max_pieces == 0 || g->pieces < opt->max_pieces))
+    {
+        int events = 0;
+        for (int i = 0; i < opt->script_len && !g->game_over; i++)
+        {
+            if (opt->script[i] == INPUT_WAIT)
+                events |= game_step(g, INPUT_NONE, g->fall_speed - g->fall_timer);
+            else
+                events |= game_step(g, opt->script[i], 0);
+        }
+
+        // Ein Durchlauf ohne eingerasteten Stein würde endlos wiederholen
+        if (!(events & GAME_EVENT_LOCKED))
+            break;
+    }
+}
+
+// Autoplayer: für jeden Stein die beste Platzierung suchen und ausführen
+static void play_ai(GameState *g, const SimOptions *opt)
+{
+    GameInput inputs[AI_MAX_INPUTS];
+
+    while (!g->game_over && (opt->max_pieces == 0 || g->pieces < opt->max_pieces))
+    {
+        AiPlacement best;
+        if (!ai_find_best(opt->ai_pool, g, &best))
+        {
+            game_step(g, INPUT_HARD_DROP, 0);
+            continue;
+        }
+
+        int n = ai_placement_inputs(g, &best, inputs);
+        for (int i = 0; i < n; i++)
+            game_step(g, inputs[i], 0);
+    }
+}
+
+void sim_play_game(GameState *g, const SimOptions *opt)
+{
+    if (opt->ai)
+        play_ai(g, opt);
+    else if (opt->script)
+        play_script(g, opt);
+    else
+        play_random(g, opt);
+}
+
+void sim_run(const SimOptions *opt, SimResult *result)
+{
+    result->games = opt->games;
+    result->pieces = 0;
+    result->lines = 0;
+    result->score = 0;
+
+    int64_t start = time_now_us();
+
+    for (int n = 0; n < opt->games; n++)
+    {
+        GameState g;
+        game_init(&g, opt->rules, opt->seed + n);
+        sim_play_game(&g, opt);
+
+        result->pieces += g.pieces;
+        result->lines += g.lines_cleared;
+        result->score += g.score;
+    }
+
+    result->seconds = (time_now_us() - start) / 1e6;
+}
+
+void sim_print_result(FILE *out, const SimResult *result)
+{
+    double seconds = result->seconds > 0 ? result->seconds : 1e-9;
+
+    fprintf(out, "Spiele:  %d\n", result->games);
+    fprintf(out, "Steine:  %lld\n", result->pieces);
+    fprintf(out, "Linien:  %lld\n", result->lines);
+    fprintf(out, "Punkte:  %lld\n", result->score);
+    fprintf(out, "Zeit:    %.3f s\n", result->seconds);
+    fprintf(out, "Spiele/s: %.0f\n", result->games / seconds);
+    fprintf(out, "Steine/s: %.0f\n", result->pieces / seconds);
+}
+
+// Work Stealing: jeder Thread hat einen Bereich von Spielnummern, den er von
+// vorne abarbeitet. Ist er leer, stiehlt er einem anderen die hintere Hälfte
+// seines Rests. Spiele dauern je nach Seed sehr unterschiedlich lang, eine
+// feste Aufteilung würde auf den langsamsten Thread warten.
+typedef struct
+{
+    pthread_mutex_t lock;
+    int begin, end; // Noch offene Spiele [begin, end)
+} SimQueue;
+
+typedef struct
+{
+    const SimOptions *opt;
+    SimQueue *queues;
+    int thread_count;
+    int index;
+    GameResult *results;
+} SimWorker;
+
+static int queue_pop(SimQueue *q, int *game)
+{
+    int ok = 0;
+    pthread_mutex_lock(&q->lock);
+    if (q->begin < q->end)
+    {
+        *game = q->begin++;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return ok;
+}
+
+// Hintere Hälfte (mindestens ein Spiel) von victim nach own verschieben
+static int queue_steal(SimQueue *own, SimQueue *victim)
+{
+    int begin = 0, end = 0;
+
+    pthread_mutex_lock(&victim->lock);
+    int left = victim->end - victim->begin;
+    if (left > 0)
+    {
+        end = victim->end;
+        begin = end - (left + 1) / 2;
+        victim->end = begin;
+    }
+    pthread_mutex_unlock(&victim->lock);
+
+    if (begin == end)
+        return 0;
+
+    pthread_mutex_lock(&own->lock);
+    own->begin = begin;
+    own->end = end;
+    pthread_mutex_unlock(&own->lock);
+    return 1;
+}
+
+static void *tournament_worker(void *arg)
+{
+    SimWorker *w = arg;
+    SimQueue *own = &w->queues[w->index];
+
+    while (1)
+    {
+        int game;
+        if (!queue_pop(own, &game))
+        {
+            int stolen = 0;
+            for (int i = 1; i < w->thread_count && !stolen; i++)
+                stolen = queue_steal(own, &w->queues[(w->index + i) % w->thread_count]);
+            if (!stolen)
+                break; // Alle Bereiche leer, es kommt nichts mehr dazu
+            continue;
+        }
+
+        GameState g;
+        game_init(&g, w->opt->rules, w->opt->seed + game);
+        sim_play_game(&g, w->opt);
+
+        GameResult *r = &w->results[game];
+        r->score = g.score;
+        r->lines = g.lines_cleared;
+        r->level = g.level;
+        r->pieces = g.pieces;
+    }
+    return NULL;
+}
+
+void sim_tournament(const SimOptions *opt, int threads, GameResult *results, SimResult *total)
+{
+    if (threads <= 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads > opt->games)
+        threads = opt->games > 0 ? opt->games : 1;
+
+    // Parallel wird pro Spiel; ein Pool ohne eigene Threads (Suchtiefe und
+    // Transpositionstabelle) darf von allen Spielen benutzt werden
+    SimOptions game_opt = *opt;
+    if (ai_pool_threads(opt->ai_pool) > 1)
+        game_opt.ai_pool = NULL;
+
+    SimQueue *queues = calloc(threads, sizeof(SimQueue));
+    SimWorker *workers = calloc(threads, sizeof(SimWorker));
+    pthread_t *ids = calloc(threads, sizeof(pthread_t));
+
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_mutex_init(&queues[i].lock, NULL);
+        queues[i].begin = (int)((long long)opt->games * i / threads);
+        queues[i].end = (int)((long long)opt->games * (i + 1) / threads);
+
+        workers[i].opt = &game_opt;
+        workers[i].queues = queues;
+        workers[i].thread_count = threads;
+        workers[i].index = i;
+        workers[i].results = results;
+    }
+
+    int64_t start = time_now_us();
+
+    // Thread 0 ist der aufrufende Thread
+    int started = 1;
+    for (int i = 1; i < threads; i++)
+    {
+        if (pthread_create(&ids[i], NULL, tournament_worker, &workers[i]) != 0)
+            break;
+        started++;
+    }
+    // Bereiche von Threads, die nicht starten konnten, werden gestohlen
+    tournament_worker(&workers[0]);
+    for (int i = 1; i < started; i++)
+        pthread_join(ids[i], NULL);
+
+    total->seconds = (time_now_us() - start) / 1e6;
+    total->games = opt->games;
+    total->pieces = 0;
+    total->lines = 0;
+    total->score = 0;
+    for (int n = 0; n < opt->games; n++)
+    {
+        total->pieces += results[n].pieces;
+        total->lines += results[n].lines;
+        total->score += results[n].score;
+    }
+
+    for (int i = 0; i < threads; i++)
+        pthread_mutex_destroy(&queues[i].lock);
+    free(ids);
+    free(workers);
+    free(queues);
+}
+
+static int compare_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Eine Spalte der Ergebnisse sortiert ausgeben (Quantile nach Rang)
+static void print_quantiles(FILE *out, const char *label, int *values, int count)
+{
+    qsort(values, count, sizeof(int), compare_int);
+
+    long long sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += values[i];
+
+    fprintf(out, "%-8s %8d %8d %8d %8d %8d %10.1f\n", label,
+            values[0], values[count * 10 / 100], values[count / 2],
+            values[count * 90 / 100], values[count - 1], (double)sum / count);
+}
+
+void sim_print_distribution(FILE *out, const GameResult *results, int count)
+{
+    if (count <= 0)
+        return;
+
+    int *values = malloc(count * sizeof(int));
+    if (!values)
+        return;
+
+    fprintf(out, "%-8s %8s %8s %8s %8s %8s %10s\n", "", "min", "p10", "p50", "p90", "max", "Mittel");
+
+    for (int i = 0; i < count; i++)
+        values[i] = results[i].score;
+    print_quantiles(out, "Punkte", values, count);
+    for (int i = 0; i < count; i++)
+        values[i] = results[i].lines;
+    print_quantiles(out, "Linien", values, count);
+    for (int i = 0; i < count; i++)
+        values[i] = results[i].level;
+    print_quantiles(out, "Level", values, count);
+    for (int i = 0; i < count; i++)
+        values[i] = results[i].pieces;
+    print_quantiles(out, "Steine", values, count);
+
+    free(values);
+}
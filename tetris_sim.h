@@ -0,0 +1,57 @@
+#ifndef TETRIS_SIM_H
+#define TETRIS_SIM_H
+
+#include <stdio.h>
+#include "tetris_core.h"
+#include "tetris_ai.h"
+
+// Headless Simulation: komplette Spiele ohne Darstellung und ohne Schlafen,
+// um Regeländerungen über Millionen von Steinen zu testen
+
+// Im Skript bedeutet INPUT_WAIT: einen Fall-Schritt abwarten
+#define INPUT_WAIT ((GameInput)-1)
+
+typedef struct
+{
+    const GameRules *rules;
+    int games;
+    int max_pieces;          // Spiel nach so vielen Steinen beenden (0 = nie)
+    const GameInput *script; // Eingaben in Schleife; NULL = zufällig
+    int script_len;
+    int ai;                  // 1 = Autoplayer statt Zufall/Skript
+    AiPool *ai_pool;         // Threads und Suchtiefe des Autoplayers (darf NULL sein)
+    uint64_t seed;           // Spiel n bekommt seed + n
+} SimOptions;
+
+typedef struct
+{
+    int games;
+    long long pieces;
+    long long lines;
+    long long score;
+    double seconds;
+} SimResult;
+
+// Ergebnis eines einzelnen Spiels im Turnier
+typedef struct
+{
+    int score;
+    int lines;
+    int level;
+    int pieces; // Überlebensdauer in Steinen
+} GameResult;
+
+// Ein Spiel bis Game Over (oder max_pieces) durchspielen
+void sim_play_game(GameState *g, const SimOptions *opt);
+
+void sim_run(const SimOptions *opt, SimResult *result);
+void sim_print_result(FILE *out, const SimResult *result);
+
+// opt->games Spiele auf threads Threads verteilen (Work Stealing). results
+// braucht Platz für opt->games Einträge, Spiel n steht immer in results[n].
+void sim_tournament(const SimOptions *opt, int threads, GameResult *results, SimResult *total);
+
+// Verteilung von Punkten, Linien, Level und Überlebensdauer ausgeben
+void sim_print_distribution(FILE *out, const GameResult *results, int count);
+
+#endif
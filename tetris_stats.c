@@ -0,0 +1,201 @@
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "tetris_stats.h"
+
+typedef struct
+{
+    atomic_uint_fast64_t buckets[STATS_BUCKETS];
+    atomic_uint_fast64_t count;
+    atomic_uint_fast64_t sum;
+    atomic_int_fast64_t max;
+} StatsHistogram;
+
+static const char *phase_names[STATS_PHASES] = {
+    "Eingabe", "Simulation", "Linien", "Frame", "Ausgabe", "Latenz"};
+
+static StatsHistogram histograms[STATS_PHASES];
+static const char *stats_path = NULL;
+static volatile sig_atomic_t dump_requested = 0;
+
+int stats_enabled = 0;
+
+static void on_sigusr1(int sig)
+{
+    (void)sig;
+    dump_requested = 1;
+}
+
+void stats_init(const char *path)
+{
+    stats_path = path;
+    stats_enabled = 1;
+
+    // Ohne SA_RESTART, damit poll() sofort zurückkommt und die Schleife
+    // den Wunsch gleich bemerkt. Das gilt nur, wenn der Haupt-Thread das
+    // Signal bekommt: bis stats_unblock_signal bleibt es blockiert, damit
+    // Eingabe-, Render- und andere Threads es schon beim Start erben.
+    struct sigaction sa;
+    sa.sa_handler = on_sigusr1;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGUSR1, &sa, NULL);
+
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+}
+
+void stats_unblock_signal()
+{
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+    pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+}
+
+int64_t stats_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Bucket für einen Wert: unterhalb von STATS_SUB_BUCKETS exakt, darüber
+// die obersten STATS_SUB_BITS + 1 Bits
+static int bucket_index(uint64_t v)
+{
+    if (v < STATS_SUB_BUCKETS)
+        return (int)v;
+
+    int exp = 63 - __builtin_clzll(v);
+    if (exp > STATS_MAX_EXP)
+        return STATS_BUCKETS - 1;
+    int sub = (int)(v >> (exp - STATS_SUB_BITS)) & (STATS_SUB_BUCKETS - 1);
+    return STATS_SUB_BUCKETS * (exp - STATS_SUB_BITS + 1) + sub;
+}
+
+// Obergrenze eines Buckets (für die Ausgabe der Perzentile)
+static uint64_t bucket_value(int index)
+{
+    if (index < STATS_SUB_BUCKETS)
+        return index;
+
+    int exp = index / STATS_SUB_BUCKETS + STATS_SUB_BITS - 1;
+    uint64_t sub = index % STATS_SUB_BUCKETS;
+    return ((STATS_SUB_BUCKETS + sub + 1) << (exp - STATS_SUB_BITS)) - 1;
+}
+
+void stats_record(StatsPhase phase, int64_t ns)
+{
+    if (!stats_enabled)
+        return;
+    if (ns < 0)
+        ns = 0;
+
+    StatsHistogram *h = &histograms[phase];
+    atomic_fetch_add_explicit(&h->buckets[bucket_index(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum, ns, memory_order_relaxed);
+
+    int_fast64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    while (ns > max && !atomic_compare_exchange_weak_explicit(&h->max, &max, ns, memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+void stats_probe(void *ctx, GameProbePoint point, int begin)
+{
+    StatsProbe *p = ctx;
+
+    if (point != GAME_PROBE_CLEAR)
+        return;
+    if (begin)
+        p->clear_start = stats_now();
+    else
+        stats_record(STATS_CLEAR, stats_now() - p->clear_start);
+}
+
+// Wert, unter dem der Anteil q aller Einträge liegt (Obergrenze des
+// Buckets, aber nie über dem gemessenen Maximum)
+static uint64_t percentile(const uint64_t *buckets, uint64_t count, uint64_t max, double q)
+{
+    uint64_t rank = (uint64_t)(q * count);
+    if (rank >= count)
+        rank = count - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < STATS_BUCKETS; i++)
+    {
+        seen += buckets[i];
+        if (seen > rank)
+            return bucket_value(i) < max ? bucket_value(i) : max;
+    }
+    return max;
+}
+
+void stats_dump(FILE *out)
+{
+    fprintf(out, "%-10s %9s %9s %9s %9s %9s %9s %9s\n", "Phase (us)", "Anzahl", "Mittel", "p50", "p90", "p99", "p99.9", "max");
+
+    for (int p = 0; p < STATS_PHASES; p++)
+    {
+        StatsHistogram *h = &histograms[p];
+
+        // Schnappschuss; während des Kopierens eingetragene Werte fehlen
+        // eventuell in count, das verschiebt die Perzentile kaum
+        static uint64_t buckets[STATS_BUCKETS];
+        uint64_t count = 0;
+        for (int i = 0; i < STATS_BUCKETS; i++)
+        {
+            buckets[i] = atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+            count += buckets[i];
+        }
+        if (count == 0)
+        {
+            fprintf(out, "%-10s %9d\n", phase_names[p], 0);
+            continue;
+        }
+
+        uint64_t sum = atomic_load_explicit(&h->sum, memory_order_relaxed);
+        uint64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+        fprintf(out, "%-10s %9llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", phase_names[p],
+                (unsigned long long)count, sum / 1e3 / count,
+                percentile(buckets, count, max, 0.5) / 1e3, percentile(buckets, count, max, 0.9) / 1e3,
+                percentile(buckets, count, max, 0.99) / 1e3, percentile(buckets, count, max, 0.999) / 1e3,
+                max / 1e3);
+    }
+}
+
+static void dump_to_file()
+{
+    if (!stats_path)
+        return;
+
+    FILE *f = fopen(stats_path, "a");
+    if (!f)
+        return;
+
+    time_t now = time(NULL);
+    char when[32];
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    fprintf(f, "== %s ==\n", when);
+    stats_dump(f);
+    fclose(f);
+}
+
+void stats_poll()
+{
+    if (dump_requested)
+    {
+        dump_requested = 0;
+        dump_to_file();
+    }
+}
+
+void stats_finish()
+{
+    if (stats_enabled)
+        dump_to_file();
+}
@@ -0,0 +1,67 @@
+#ifndef TETRIS_STATS_H
+#define TETRIS_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "tetris_core.h"
+
+// Zeitmessung der Phasen einer Schleifenrunde. Jede Phase hat ein
+// Histogramm mit logarithmischen Buckets (wie HdrHistogram: pro
+// Zweierpotenz STATS_SUB_BUCKETS lineare Unterteilungen, also etwa 3%
+// Genauigkeit über den ganzen Bereich). Eintragen ist lock-frei und geht aus
+// jedem Thread.
+
+typedef enum
+{
+    STATS_INPUT,   // Eingaben lesen und anwenden
+    STATS_SIM,     // Simulationsschritte (Schwerkraft)
+    STATS_CLEAR,   // clear_lines beim Einrasten
+    STATS_COMPOSE, // Frame zusammenbauen
+    STATS_FLUSH,   // refresh() bzw. write() ans Terminal
+    STATS_LATENCY, // Taste gelesen bis Frame mit ihrer Wirkung ausgegeben
+    STATS_PHASES
+} StatsPhase;
+
+#define STATS_SUB_BITS 5
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BITS)
+#define STATS_MAX_EXP 40 // Werte bis 2^40 ns (etwa 18 Minuten)
+#define STATS_BUCKETS (STATS_SUB_BUCKETS * (STATS_MAX_EXP - STATS_SUB_BITS + 2))
+
+// 1 nach stats_init; die Frontends messen nur dann
+extern int stats_enabled;
+
+// Messung einschalten; Ausgabe nach path beim Beenden und bei SIGUSR1.
+// SIGUSR1 ist danach im aufrufenden Thread blockiert, alle später
+// gestarteten Threads erben das und nehmen es nie an.
+void stats_init(const char *path);
+
+// Im Haupt-Thread aufrufen, sobald die Hilfsthreads laufen: SIGUSR1 trifft
+// dann immer ihn und unterbricht sein poll()
+void stats_unblock_signal();
+
+// Monotone Uhr in ns
+int64_t stats_now();
+
+// Ohne stats_init passiert nichts
+void stats_record(StatsPhase phase, int64_t ns);
+
+// Pro Spiel, als ctx für stats_probe
+typedef struct
+{
+    int64_t clear_start;
+} StatsProbe;
+
+// Für GameState.probe mit einem StatsProbe als ctx: misst clear_lines als
+// STATS_CLEAR
+void stats_probe(void *ctx, GameProbePoint point, int begin);
+
+// In der Spielschleife aufrufen: schreibt die Histogramme, wenn seit dem
+// letzten Aufruf SIGUSR1 kam
+void stats_poll();
+
+void stats_dump(FILE *out);
+
+// Histogramme in die Datei aus stats_init schreiben
+void stats_finish();
+
+#endif
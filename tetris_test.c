@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tetris_ai.h"
+#include "tetris_core.h"
+#include "tetris_replay.h"
+
+// Prüfungen für Fälle, die beim Spielen kaum auffallen. Jede Prüfung gibt
+// die Anzahl ihrer Fehler zurück; der Rückgabewert des Programms ist 0,
+// wenn alle bestanden sind.
+//
+//   ./tetris_test
+
+#define CHECK(cond, ...)                                   \
+    do                                                     \
+    {                                                      \
+        if (!(cond))                                       \
+        {                                                  \
+            printf("  %s:%d: ", __FILE__, __LINE__);       \
+            printf(__VA_ARGS__);                           \
+            printf("\n");                                  \
+            failures++;                                    \
+        }                                                  \
+    } while (0)
+
+// Spiel aufnehmen, in dem nach ein paar frühen Eingaben nur noch die
+// Schwerkraft in Schritten von dt ms läuft, bis es oben voll ist. Die Länge
+// beim Abspielen muss genau die Zeit sein, zu der das Spiel live endete.
+static int replay_end_at_topout(int dt)
+{
+    int failures = 0;
+    char path[] = "/tmp/tetris_test_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        printf("  keine Temp-Datei\n");
+        return 1;
+    }
+    close(fd);
+
+    GameState g;
+    game_init(&g, &rules_ncurses, 42);
+    ReplayWriter *w = replay_open(path, &g);
+    CHECK(w != NULL, "replay_open(%s)", path);
+    if (!w)
+        return failures;
+
+    static const GameInput early[] = {INPUT_LEFT, INPUT_ROTATE, INPUT_HARD_DROP, INPUT_RIGHT, INPUT_HARD_DROP};
+    for (size_t i = 0; i < sizeof(early) / sizeof(early[0]); i++)
+    {
+        replay_record(w, &g, early[i]);
+        game_step(&g, early[i], 0);
+        game_step(&g, INPUT_NONE, 100);
+    }
+    while (!g.game_over)
+        game_step(&g, INPUT_NONE, dt);
+    replay_close(w);
+
+    ReplayPlayer p;
+    CHECK(replay_player_open(&p, path, REPLAY_KEYFRAME_MS), "replay_player_open(%s)", path);
+    unlink(path);
+    if (!p.data)
+        return failures;
+
+    CHECK(p.end_ms == g.time_ms, "dt %d: end_ms %lld, live zu Ende bei %lld ms", dt,
+          (long long)p.end_ms, (long long)g.time_ms);
+    replay_player_seek(&p, p.end_ms);
+    CHECK(p.game.game_over, "dt %d: bei end_ms nicht zu Ende", dt);
+    CHECK(p.game.pieces == g.pieces, "dt %d: %d Steine statt %d", dt, p.game.pieces, g.pieces);
+    replay_player_close(&p);
+    return failures;
+}
+
+// Die Endzeit darf nicht davon abhängen, wie die Zeit aufgeteilt wird
+static int topout_time_independent_of_dt()
+{
+    int failures = 0;
+    int64_t end[3];
+    static const int dts[3] = {1, 16, 100000};
+
+    for (int i = 0; i < 3; i++)
+    {
+        GameState g;
+        game_init(&g, &rules_ncurses, 7);
+        while (!g.game_over)
+            game_step(&g, INPUT_NONE, dts[i]);
+        end[i] = g.time_ms;
+    }
+    CHECK(end[0] == end[1] && end[1] == end[2], "Ende bei %lld / %lld / %lld ms", (long long)end[0],
+          (long long)end[1], (long long)end[2]);
+    return failures;
+}
+
+static int replay_end_small_steps()
+{
+    return replay_end_at_topout(16);
+}
+
+static int replay_end_one_big_step()
+{
+    return replay_end_at_topout(600000);
+}
+
+// Eingaben, die den aktuellen Stein r mal drehen, ganz nach links und dann
+// k Spalten nach rechts schieben; gibt die gesammelten Ereignisse zurück
+static int steer(GameState *g, int r, int k)
+{
+    int events = 0;
+    for (int i = 0; i < r; i++)
+        events |= game_step(g, INPUT_ROTATE, 0);
+    for (int i = 0; i < WIDTH; i++)
+        events |= game_step(g, INPUT_LEFT, 0);
+    for (int i = 0; i < k; i++)
+        events |= game_step(g, INPUT_RIGHT, 0);
+    return events;
+}
+
+// heights und board_hash müssen nach jedem Einrasten dasselbe sein wie
+// eine Neuberechnung aus board_rows
+static int check_derived(const GameState *g)
+{
+    int failures = 0;
+    uint8_t heights[WIDTH];
+
+    rows_heights(g->board_rows, heights);
+    for (int x = 0; x < WIDTH; x++)
+        CHECK(g->heights[x] == heights[x], "Stein %d: Spalte %d Höhe %d statt %d", g->pieces, x, g->heights[x],
+              heights[x]);
+    CHECK(g->board_hash == zobrist_rows(g->board_rows), "Stein %d: board_hash weicht ab", g->pieces);
+    return failures;
+}
+
+// Zufällige Spiele: meist setzt ein gieriger Spieler mit ai_evaluate den
+// Stein so, dass Linien fallen, sonst landet er irgendwo, damit Überhänge
+// und Löcher entstehen
+static int derived_match_recompute()
+{
+    int failures = 0;
+    int lines = 0;
+    Rng rng;
+    rng_seed(&rng, 1);
+
+    for (int seed = 1; seed <= 20 && !failures; seed++)
+    {
+        GameState g;
+        game_init(&g, &rules_ncurses, seed);
+
+        while (!g.game_over && g.pieces < 500 && !failures)
+        {
+            if (rng_below(&rng, 10) == 0)
+                game_step(&g, INPUT_HOLD, 0);
+
+            int r = rng_below(&rng, 4);
+            int k = rng_below(&rng, WIDTH);
+            if (rng_below(&rng, 8) != 0)
+            {
+                int best = 0, found = 0;
+                for (int tr = 0; tr < 4; tr++)
+                {
+                    for (int tk = 0; tk < WIDTH; tk++)
+                    {
+                        GameState c = g;
+                        if (steer(&c, tr, tk) & GAME_EVENT_LOCKED)
+                            continue;
+                        game_step(&c, INPUT_HARD_DROP, 0);
+                        int score = ai_evaluate(c.board_rows, c.lines_cleared - g.lines_cleared);
+                        if (!found || score > best || (score == best && rng_below(&rng, 2)))
+                        {
+                            found = 1;
+                            best = score;
+                            r = tr;
+                            k = tk;
+                        }
+                    }
+                }
+            }
+            int events = steer(&g, r, k) | game_step(&g, INPUT_HARD_DROP, 0);
+            if (events & GAME_EVENT_LOCKED)
+                failures += check_derived(&g);
+        }
+        lines += g.lines_cleared;
+    }
+    CHECK(lines > 0, "keine Linie gelöscht");
+    return failures;
+}
+
+typedef struct
+{
+    const char *name;
+    int (*run)();
+} Test;
+
+static const Test tests[] = {
+    {"topout_time_independent_of_dt", topout_time_independent_of_dt},
+    {"replay_end_small_steps", replay_end_small_steps},
+    {"replay_end_one_big_step", replay_end_one_big_step},
+    {"derived_match_recompute", derived_match_recompute},
+};
+
+int main()
+{
+    int failed = 0;
+    int count = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < count; i++)
+    {
+        int failures = tests[i].run();
+        printf("%-40s %s\n", tests[i].name, failures ? "FEHLER" : "ok");
+        if (failures)
+            failed++;
+    }
+    printf("%d von %d bestanden\n", count - failed, count);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tetris_time.h"
+
+int64_t time_now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void sim_clock_start(SimClock *c)
+{
+    c->last_us = time_now_us();
+    c->accumulator = 0;
+    c->sim_ms = 0;
+}
+
+int sim_clock_advance(SimClock *c)
+{
+    return sim_clock_advance_to(c, time_now_us());
+}
+
+int sim_clock_advance_to(SimClock *c, int64_t now)
+{
+    // Zeitstempel vor dem letzten Stand (z.B. eine Taste, die gelesen wurde,
+    // bevor die Simulation weitergezählt hat) bringen keine Schritte
+    if (now <= c->last_us)
+        return 0;
+
+    c->accumulator += now - c->last_us;
+    c->last_us = now;
+
+    if (c->accumulator > (int64_t)SIM_MAX_CATCHUP_MS * 1000)
+        c->accumulator = (int64_t)SIM_MAX_CATCHUP_MS * 1000;
+
+    int steps = (int)(c->accumulator / (SIM_STEP_MS * 1000));
+    c->accumulator -= (int64_t)steps * SIM_STEP_MS * 1000;
+    c->sim_ms += (int64_t)steps * SIM_STEP_MS;
+    return steps;
+}
+
+int sim_clock_timeout_ms(const SimClock *c, int steps)
+{
+    int64_t wait_us = (int64_t)steps * SIM_STEP_MS * 1000 - c->accumulator - (time_now_us() - c->last_us);
+    if (wait_us <= 0)
+        return 0;
+    return (int)((wait_us + 999) / 1000);
+}
+
+uint64_t seed_from_args(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            return strtoull(argv[i] + 7, NULL, 0);
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,41 @@
+#ifndef TETRIS_TIME_H
+#define TETRIS_TIME_H
+
+#include <stdint.h>
+
+// Die Simulation läuft in festen Schritten von SIM_STEP_MS Millisekunden.
+// Schwerkraft, Soft Drop und Einrasten hängen nur von der Anzahl der
+// Schritte ab, nicht davon, wie oft oder wie pünktlich der Prozess aufwacht.
+#define SIM_STEP_MS 1
+
+// Mehr als so viel Rückstand wird nicht nachsimuliert (z.B. nach Ctrl-Z)
+#define SIM_MAX_CATCHUP_MS 1000
+
+typedef struct
+{
+    int64_t last_us;     // Wanduhr beim letzten sim_clock_advance
+    int64_t accumulator; // Noch nicht simulierte Zeit in us
+    int64_t sim_ms;      // Insgesamt simulierte Zeit in ms
+} SimClock;
+
+// Monotone Wanduhr (CLOCK_MONOTONIC) in Mikrosekunden
+int64_t time_now_us();
+
+void sim_clock_start(SimClock *c);
+
+// Nimmt die seit dem letzten Aufruf vergangene Zeit auf und gibt zurück,
+// wie viele Simulationsschritte jetzt fällig sind
+int sim_clock_advance(SimClock *c);
+
+// Wie sim_clock_advance, aber bis zum Zeitpunkt now_us (time_now_us) statt
+// bis jetzt; für Eingaben mit eigenem Zeitstempel
+int sim_clock_advance_to(SimClock *c, int64_t now_us);
+
+// Millisekunden (aufgerundet), bis steps weitere Schritte fällig sind;
+// passend als poll() Timeout
+int sim_clock_timeout_ms(const SimClock *c, int steps);
+
+// Seed aus der Kommandozeile ("--seed=n"), sonst aus der Uhrzeit
+uint64_t seed_from_args(int argc, char *argv[]);
+
+#endif
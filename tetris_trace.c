@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "tetris_trace.h"
+#include "tetris_stats.h"
+
+// Ring für mehrere Schreiber und einen Leser: jeder Platz trägt eine
+// Sequenznummer. seq == pos heißt frei für den Schreiber an Position pos,
+// seq == pos + 1 heißt fertig geschrieben für den Leser.
+typedef struct
+{
+    atomic_uint_fast64_t seq;
+    const char *name;
+    int64_t start_ns;
+    int64_t dur_ns;
+    int tid;
+} TraceSlot;
+
+static TraceSlot *ring;
+static atomic_uint_fast64_t head; // Nächste Position für Schreiber
+static uint64_t tail;             // Nächste Position für den Leser
+static atomic_uint_fast64_t dropped;
+
+static FILE *trace_file;
+static int64_t trace_start_ns;
+static int events_written;
+
+static pthread_t flush_thread;
+static pthread_mutex_t flush_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_wake = PTHREAD_COND_INITIALIZER;
+static int flush_stop;
+
+// Kleine Thread-Nummern für "tid", in der Reihenfolge des ersten Ereignisses
+static atomic_int next_tid = 1;
+static __thread int thread_tid;
+
+int trace_enabled = 0;
+
+void trace_complete(const char *name, int64_t start_ns, int64_t end_ns)
+{
+    if (!trace_enabled)
+        return;
+    if (!thread_tid)
+        thread_tid = atomic_fetch_add(&next_tid, 1);
+
+    uint64_t pos = atomic_load_explicit(&head, memory_order_relaxed);
+    TraceSlot *slot;
+    while (1)
+    {
+        slot = &ring[pos & (TRACE_RING_SIZE - 1)];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == pos)
+        {
+            if (atomic_compare_exchange_weak_explicit(&head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (seq < pos)
+        {
+            // Voll: der Leser ist eine Runde zurück
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&head, memory_order_relaxed);
+        }
+    }
+
+    slot->name = name;
+    slot->start_ns = start_ns;
+    slot->dur_ns = end_ns - start_ns;
+    slot->tid = thread_tid;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+void trace_probe(void *ctx, GameProbePoint point, int begin)
+{
+    static const char *names[2] = {"merge_tetromino", "clear_lines"};
+    TraceProbe *p = ctx;
+
+    if (begin)
+        p->start[point] = stats_now();
+    else
+        trace_complete(names[point], p->start[point], stats_now());
+}
+
+void trace_loop_probe(void *ctx, GameProbePoint point, int begin)
+{
+    LoopProbe *p = ctx;
+    stats_probe(&p->stats, point, begin);
+    trace_probe(&p->trace, point, begin);
+}
+
+// Alles Fertige aus dem Ring in die Datei schreiben
+static void drain()
+{
+    while (1)
+    {
+        TraceSlot *slot = &ring[tail & (TRACE_RING_SIZE - 1)];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != tail + 1)
+            break;
+
+        fprintf(trace_file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                events_written ? ",\n" : "", slot->name,
+                (slot->start_ns - trace_start_ns) / 1e3, slot->dur_ns / 1e3, slot->tid);
+        events_written++;
+
+        atomic_store_explicit(&slot->seq, tail + TRACE_RING_SIZE, memory_order_release);
+        tail++;
+    }
+    fflush(trace_file);
+}
+
+static void *flush_main(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&flush_lock);
+    while (!flush_stop)
+    {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += TRACE_FLUSH_MS * 1000000L;
+        if (until.tv_nsec >= 1000000000L)
+        {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&flush_wake, &flush_lock, &until);
+
+        pthread_mutex_unlock(&flush_lock);
+        drain();
+        pthread_mutex_lock(&flush_lock);
+    }
+    pthread_mutex_unlock(&flush_lock);
+    return NULL;
+}
+
+int trace_open(const char *path)
+{
+    ring = calloc(TRACE_RING_SIZE, sizeof(TraceSlot));
+    trace_file = fopen(path, "w");
+    if (!ring || !trace_file)
+    {
+        free(ring);
+        if (trace_file)
+            fclose(trace_file);
+        return 0;
+    }
+
+    for (uint64_t i = 0; i < TRACE_RING_SIZE; i++)
+        atomic_init(&ring[i].seq, i);
+
+    trace_start_ns = stats_now();
+    fputs("{\"traceEvents\":[\n", trace_file);
+
+    if (pthread_create(&flush_thread, NULL, flush_main, NULL) != 0)
+    {
+        fclose(trace_file);
+        free(ring);
+        return 0;
+    }
+    trace_enabled = 1;
+    return 1;
+}
+
+void trace_close()
+{
+    if (!trace_enabled)
+        return;
+    trace_enabled = 0;
+
+    pthread_mutex_lock(&flush_lock);
+    flush_stop = 1;
+    pthread_cond_signal(&flush_wake);
+    pthread_mutex_unlock(&flush_lock);
+    pthread_join(flush_thread, NULL);
+
+    drain();
+    fprintf(trace_file, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%llu}}\n",
+            (unsigned long long)atomic_load(&dropped));
+    fclose(trace_file);
+    free(ring);
+    ring = NULL;
+}
@@ -0,0 +1,58 @@
+#ifndef TETRIS_TRACE_H
+#define TETRIS_TRACE_H
+
+#include <stdint.h>
+#include "tetris_core.h"
+#include "tetris_stats.h"
+
+// Trace der Spielschleife im Chrome Trace Event Format (chrome://tracing,
+// ui.perfetto.dev). Ereignisse landen in einem vorher angelegten Ring und
+// werden von einem eigenen Thread in die Datei geschrieben; die Schleife
+// selbst schreibt nie. Ist der Ring voll, gehen Ereignisse verloren (und
+// werden am Ende gezählt), gewartet wird nicht.
+
+#define TRACE_RING_SIZE 65536 // Zweierpotenz
+#define TRACE_FLUSH_MS 50
+
+// 1 nach erfolgreichem trace_open
+extern int trace_enabled;
+
+// Datei anlegen und den Schreib-Thread starten; 0 bei Fehlern
+int trace_open(const char *path);
+
+// Restliche Ereignisse schreiben und die Datei abschließen
+void trace_close();
+
+// Uhr für Messpunkte der Schleifen (wie stats_now); liest die Uhr nur,
+// wenn Statistik oder Trace an sind, sonst 0
+static inline int64_t trace_now()
+{
+    return stats_enabled || trace_enabled ? stats_now() : 0;
+}
+
+// Abgeschlossenes Ereignis von start_ns bis end_ns (Uhr wie stats_now).
+// name muss dauerhaft gültig sein (String-Literal). Aus jedem Thread.
+void trace_complete(const char *name, int64_t start_ns, int64_t end_ns);
+
+// Pro Spiel, als ctx für trace_probe
+typedef struct
+{
+    int64_t start[2]; // Beginn pro GameProbePoint
+} TraceProbe;
+
+// Für GameState.probe mit einem TraceProbe als ctx: merge_tetromino und
+// clear_lines als Ereignisse
+void trace_probe(void *ctx, GameProbePoint point, int begin);
+
+// Für die Frontends: Statistik und Trace zusammen an einem Spiel
+typedef struct
+{
+    StatsProbe stats;
+    TraceProbe trace;
+} LoopProbe;
+
+// Für GameState.probe mit einem LoopProbe als ctx: gibt jeden Messpunkt an
+// stats_probe und trace_probe weiter
+void trace_loop_probe(void *ctx, GameProbePoint point, int begin);
+
+#endif
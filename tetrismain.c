@@ -1,114 +1,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include <unistd.h>
-#include <ncurses.h>
+#include <poll.h>
+#include <termios.h>
+#include "tetris_core.h"
+#include "tetris_render_ansi.h"
+#include "tetris_render_thread.h"
+#include "tetris_input.h"
+#include "tetris_time.h"
+#include "tetris_replay.h"
+#include "tetris_stats.h"
+#include "tetris_trace.h"
 
-// Spielfeld Dimensionen
-#define WIDTH 10
-#define HEIGHT 20
 #define PREVIEW_SIZE 4
 
-// Farben für Terminal
-#define COLOR_RESET "\033[0m"
-#define COLOR_CYAN "\033[36m"
-#define COLOR_YELLOW "\033[33m"
-#define COLOR_PURPLE "\033[35m"
-#define COLOR_GREEN "\033[32m"
-#define COLOR_RED "\033[31m"
-#define COLOR_BLUE "\033[34m"
-#define COLOR_ORANGE "\033[38;5;208m"
-#define COLOR_GRAY "\033[90m"
-
-int shapes[7][4][4] = {
-    // I
-    {{0, 0, 0, 0},
-     {1, 1, 1, 1},
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    // O
-    {{0, 0, 0, 0},
-     {0, 1, 1, 0},
-     {0, 1, 1, 0},
-     {0, 0, 0, 0}},
-    // T
-    {{0, 0, 0, 0},
-     {0, 1, 1, 1},
-     {0, 0, 1, 0},
-     {0, 0, 0, 0}},
-    // S
-    {{0, 0, 0, 0},
-     {0, 0, 1, 1},
-     {0, 1, 1, 0},
-     {0, 0, 0, 0}},
-    // Z
-    {{0, 0, 0, 0},
-     {0, 1, 1, 0},
-     {0, 0, 1, 1},
-     {0, 0, 0, 0}},
-    // J
-    {{0, 0, 0, 0},
-     {0, 1, 1, 1},
-     {0, 0, 0, 1},
-     {0, 0, 0, 0}},
-    // L
-    {{0, 0, 0, 0},
-     {0, 1, 1, 1},
-     {0, 1, 0, 0},
-     {0, 0, 0, 0}}};
-
-const char *colors[7] = {
-    COLOR_CYAN,   // I
-    COLOR_YELLOW, // O
-    COLOR_PURPLE, // T
-    COLOR_GREEN,  // S
-    COLOR_RED,    // Z
-    COLOR_BLUE,   // J
-    COLOR_ORANGE  // L
-};
-
-typedef struct
-{
-    int x, y;
-    int type;
-    int rotation;
-} Tetromino;
-
-int board[HEIGHT][WIDTH] = {0};
-int score = 0;
-int level = 1;
-int lines_cleared = 0;
-int game_over = 0;
-
 struct termios orig_termios;
 
-#define INPUT_BUFFER_SIZE 10
-char input_buffer[INPUT_BUFFER_SIZE];
-int input_buffer_start = 0;
-int input_buffer_end = 0;
-
-void add_to_input_buffer(char c)
-{
-    int next = (input_buffer_end + 1) % INPUT_BUFFER_SIZE;
-    if (next != input_buffer_start)
-    {
-        input_buffer[input_buffer_end] = c;
-        input_buffer_end = next;
-    }
-}
-
-int get_from_input_buffer(char *c)
-{
-    if (input_buffer_start == input_buffer_end)
-    {
-        return 0;
-    }
-    *c = input_buffer[input_buffer_start];
-    input_buffer_start = (input_buffer_start + 1) % INPUT_BUFFER_SIZE;
-    return 1;
-}
-
 void disable_raw_mode()
 {
     tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
@@ -127,402 +35,164 @@ void enable_raw_mode()
     tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
 }
 
-int kbhit()
-{
-    int oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-
-    int ch = getchar();
-
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-
-    if (ch != EOF)
-    {
-        ungetc(ch, stdin);
-        return 1;
-    }
-
-    return 0;
-}
-
 void clear_screen()
 {
     printf("\033[2J\033[H");
 }
 
-void rotate_shape(int shape[4][4], int rotated[4][4])
+// Taste (vom InputDecoder) auf Spiel-Eingabe abbilden
+GameInput map_key(int key)
 {
-    for (int i = 0; i < 4; i++)
-    {
-        for (int j = 0; j < 4; j++)
-        {
-            rotated[i][j] = shape[3 - j][i];
-        }
-    }
+    if (key == 'q' || key == 'Q')
+        return INPUT_QUIT;
+    if (key == 'a' || key == 'A' || key == TERM_KEY_LEFT)
+        return INPUT_LEFT;
+    if (key == 'd' || key == 'D' || key == TERM_KEY_RIGHT)
+        return INPUT_RIGHT;
+    if (key == 's' || key == 'S' || key == TERM_KEY_DOWN)
+        return INPUT_SOFT_DROP;
+    if (key == 'w' || key == 'W' || key == TERM_KEY_UP)
+        return INPUT_ROTATE;
+    if (key == 'z' || key == 'Z')
+        return INPUT_ROTATE_CCW;
+    return INPUT_NONE;
 }
 
-int check_collision(Tetromino *t)
+int main(int argc, char *argv[])
 {
-    int current_shape[4][4];
-    memcpy(current_shape, shapes[t->type], sizeof(current_shape));
-
-    for (int r = 0; r < t->rotation % 4; r++)
-    {
-        int temp[4][4];
-        rotate_shape(current_shape, temp);
-        memcpy(current_shape, temp, sizeof(current_shape));
-    }
-
-    for (int i = 0; i < 4; i++)
+    const char *record_path = NULL;
+    const char *trace_path = NULL;
+    int ring_size = INPUT_RING_DEFAULT;
+    for (int i = 1; i < argc; i++)
     {
-        for (int j = 0; j < 4; j++)
-        {
-            if (current_shape[i][j])
-            {
-                int x = t->x + j;
-                int y = t->y + i;
-
-                if (x < 0 || x >= WIDTH || y >= HEIGHT)
-                    return 1;
-                if (y >= 0 && board[y][x])
-                    return 1;
-            }
-        }
+        if (strncmp(argv[i], "--record=", 9) == 0)
+            record_path = argv[i] + 9;
+        else if (strncmp(argv[i], "--stats=", 8) == 0)
+            stats_init(argv[i] + 8);
+        else if (strncmp(argv[i], "--trace=", 8) == 0)
+            trace_path = argv[i] + 8;
+        else if (strncmp(argv[i], "--input-ring=", 13) == 0)
+            ring_size = atoi(argv[i] + 13);
     }
-    return 0;
-}
 
-void merge_tetromino(Tetromino *t)
-{
-    int current_shape[4][4];
-    memcpy(current_shape, shapes[t->type], sizeof(current_shape));
-
-    for (int r = 0; r < t->rotation % 4; r++)
+    GameState game;
+    game_init(&game, &rules_ansi, seed_from_args(argc, argv));
+    if (trace_path && !trace_open(trace_path))
     {
-        int temp[4][4];
-        rotate_shape(current_shape, temp);
-        memcpy(current_shape, temp, sizeof(current_shape));
+        fprintf(stderr, "Trace %s kann nicht angelegt werden\n", trace_path);
+        return 1;
     }
-
-    for (int i = 0; i < 4; i++)
+    LoopProbe probe = {0};
+    if (stats_enabled || trace_enabled)
     {
-        for (int j = 0; j < 4; j++)
-        {
-            if (current_shape[i][j])
-            {
-                int x = t->x + j;
-                int y = t->y + i;
-                if (y >= 0 && y < HEIGHT && x >= 0 && x < WIDTH)
-                {
-                    board[y][x] = t->type + 1;
-                }
-            }
-        }
+        game.probe = trace_loop_probe;
+        game.probe_ctx = &probe;
     }
-}
-
-int clear_lines()
-{
-    int cleared = 0;
 
-    for (int i = HEIGHT - 1; i >= 0; i--)
+    ReplayWriter *replay = NULL;
+    if (record_path && !(replay = replay_open(record_path, &game)))
     {
-        int full = 1;
-        for (int j = 0; j < WIDTH; j++)
-        {
-            if (!board[i][j])
-            {
-                full = 0;
-                break;
-            }
-        }
-
-        if (full)
-        {
-            cleared++;
-            for (int k = i; k > 0; k--)
-            {
-                for (int j = 0; j < WIDTH; j++)
-                {
-                    board[k][j] = board[k - 1][j];
-                }
-            }
-            for (int j = 0; j < WIDTH; j++)
-            {
-                board[0][j] = 0;
-            }
-            i++;
-        }
+        fprintf(stderr, "Replay %s kann nicht angelegt werden\n", record_path);
+        return 1;
     }
 
-    return cleared;
-}
-
-void draw_board(Tetromino *current)
-{
-    clear_screen();
-
-    printf("\n");
-    printf("  ╔══════════════════════════════════════╗\n");
-    printf("  ║              TETRIS GAME             ║\n");
-    printf("  ╚══════════════════════════════════════╝\n\n");
-
-    printf("  Score: %d    Level: %d    Lines: %d\n\n", score, level, lines_cleared);
-
-    int display[HEIGHT][WIDTH];
-    memcpy(display, board, sizeof(board));
+    enable_raw_mode();
 
-    if (current)
+    // Tasten liest ab hier nur noch der Eingabe-Thread
+    InputThread *input = input_thread_start(STDIN_FILENO, ring_size);
+    if (!input)
     {
-        int current_shape[4][4];
-        memcpy(current_shape, shapes[current->type], sizeof(current_shape));
-
-        for (int r = 0; r < current->rotation % 4; r++)
-        {
-            int temp[4][4];
-            rotate_shape(current_shape, temp);
-            memcpy(current_shape, temp, sizeof(current_shape));
-        }
-
-        for (int i = 0; i < 4; i++)
-        {
-            for (int j = 0; j < 4; j++)
-            {
-                if (current_shape[i][j])
-                {
-                    int x = current->x + j;
-                    int y = current->y + i;
-                    if (y >= 0 && y < HEIGHT && x >= 0 && x < WIDTH)
-                    {
-                        display[y][x] = current->type + 1;
-                    }
-                }
-            }
-        }
+        fprintf(stderr, "Eingabe-Thread kann nicht gestartet werden\n");
+        return 1;
     }
 
-    printf("  ╔");
-    for (int i = 0; i < WIDTH * 2; i++)
-        printf("═");
-    printf("╗\n");
-
-    for (int i = 0; i < HEIGHT; i++)
+    // Gezeichnet wird ab hier nur noch im Render-Thread
+    static const Renderer renderer = {ansi_compose, ansi_flush, ansi_invalidate, "write"};
+    RenderThread *render = render_thread_start(&renderer);
+    if (!render)
     {
-        printf("  ║");
-        for (int j = 0; j < WIDTH; j++)
-        {
-            if (display[i][j])
-            {
-                printf("%s██%s", colors[display[i][j] - 1], COLOR_RESET);
-            }
-            else
-            {
-                if ((i + j) % 2 == 0)
-                {
-                    printf("%s░░%s", COLOR_GRAY, COLOR_RESET);
-                }
-                else
-                {
-                    printf("  ");
-                }
-            }
-        }
-        printf("║\n");
+        input_thread_stop(input);
+        fprintf(stderr, "Render-Thread kann nicht gestartet werden\n");
+        return 1;
     }
 
-    printf("  ╚");
-    for (int i = 0; i < WIDTH * 2; i++)
-        printf("═");
-    printf("╝\n\n");
+    // Alle Hilfsthreads laufen und haben SIGUSR1 blockiert geerbt
+    stats_unblock_signal();
 
-    printf("  Steuerung:\n");
-    printf("  ← → : Bewegen    ↓ : Schneller    ↑ : Rotieren    Q : Beenden\n");
+    SimClock sim;
+    int needs_redraw = 1;
 
+    printf("\033[?25l"); // Cursor verstecken
     fflush(stdout);
-}
-
-Tetromino create_tetromino()
-{
-    Tetromino t;
-    t.type = rand() % 7;
-    t.x = WIDTH / 2 - 2;
-    t.y = -1;
-    t.rotation = 0;
-    return t;
-}
 
-int main()
-{
-    srand(time(NULL));
-    enable_raw_mode();
+    sim_clock_start(&sim);
 
-    Tetromino current = create_tetromino();
+    // Zeitpunkt, zu dem die älteste Taste seit dem letzten übergebenen Frame
+    // gelesen wurde (0 = keine), für die Latenz bis zur Ausgabe
+    int64_t key_read_ns = 0;
 
-    clock_t last_fall = clock();
-    clock_t last_draw = clock();
-    int fall_speed = 30000;
-    int draw_interval = 1600;
-    int needs_redraw = 1;
-
-    printf("\033[?25l"); // Cursor verstecken
-
-    while (!game_over)
+    while (!game.game_over)
     {
-        while (kbhit())
+        // Blockieren bis eine Taste kommt oder der nächste Fall-Schritt
+        // fällig ist, statt alle 0,5ms aufzuwachen
+        int timeout = sim_clock_timeout_ms(&sim, (game.fall_speed - game.fall_timer) / SIM_STEP_MS);
+        if (timeout > 0)
         {
-            char c = getchar();
-            add_to_input_buffer(c);
+            struct pollfd pfd = {input_thread_wake_fd(input), POLLIN, 0};
+            int64_t t_sleep = trace_now();
+            poll(&pfd, 1, timeout);
+            trace_complete("Schlafen", t_sleep, trace_now());
         }
-
-        int input_handled = 0;
-
-        char c;
-        while (get_from_input_buffer(&c))
+        stats_poll();
+
+        // Tasten in Lesereihenfolge anwenden. Vor jeder Taste läuft die
+        // Simulation bis zu ihrem Zeitstempel, so dass sie im selben
+        // Fall-Schritt wirkt, in dem sie gedrückt wurde
+        int64_t t_input = trace_now();
+        InputEvent ev;
+        while (!game.game_over && input_thread_pop(input, &ev))
         {
-            if (c == 'q' || c == 'Q')
-            {
-                game_over = 1;
+            int steps = sim_clock_advance_to(&sim, ev.time_us);
+            if (steps > 0 && game_step(&game, INPUT_NONE, steps * SIM_STEP_MS))
+                needs_redraw = 1;
+            if (game.game_over)
                 break;
-            }
-
-            Tetromino temp = current;
 
-            if (c == 'a' || c == 'A')
+            GameInput key = map_key(ev.key);
+            replay_record(replay, &game, key);
+            if (game_step(&game, key, 0))
             {
-                temp.x--;
-                if (!check_collision(&temp))
-                {
-                    current = temp;
-                    input_handled = 1;
-                }
+                needs_redraw = 1;
+                if (key_read_ns == 0)
+                    key_read_ns = ev.time_us * 1000;
             }
-            else if (c == 'd' || c == 'D')
-            {
-                temp.x++;
-                if (!check_collision(&temp))
-                {
-                    current = temp;
-                    input_handled = 1;
-                }
-            }
-            else if (c == 's' || c == 'S')
-            {
-                temp.y++;
-                if (!check_collision(&temp))
-                {
-                    current = temp;
-                    input_handled = 1;
-                }
-            }
-            else if (c == 'w' || c == 'W')
-            {
-                temp.rotation++;
-                if (!check_collision(&temp))
-                {
-                    current = temp;
-                    input_handled = 1;
-                }
-            }
-
-            else if (c == 27)
-            {
-                char next1 = getchar();
-                if (next1 == '[')
-                {
-                    c = getchar();
-                    temp = current;
-
-                    if (c == 'A')
-                    {
-                        temp.rotation++;
-                        if (!check_collision(&temp))
-                        {
-                            current = temp;
-                            input_handled = 1;
-                        }
-                    }
-                    else if (c == 'B')
-                    {
-                        temp.y++;
-                        if (!check_collision(&temp))
-                        {
-                            current = temp;
-                            input_handled = 1;
-                        }
-                    }
-                    else if (c == 'C')
-                    {
-                        temp.x++;
-                        if (!check_collision(&temp))
-                        {
-                            current = temp;
-                            input_handled = 1;
-                        }
-                    }
-                    else if (c == 'D')
-                    {
-                        temp.x--;
-                        if (!check_collision(&temp))
-                        {
-                            current = temp;
-                            input_handled = 1;
-                        }
-                    }
-                }
-            }
-        }
-
-        if (input_handled)
-        {
-            needs_redraw = 1;
         }
 
-        clock_t now = clock();
-        if ((now - last_fall) * 1000000 / CLOCKS_PER_SEC >= fall_speed)
+        // Simulation in festen Schritten bis jetzt nachziehen
+        int64_t t_sim = trace_now();
+        stats_record(STATS_INPUT, t_sim - t_input);
+        trace_complete("Eingabe", t_input, t_sim);
+        int steps = sim_clock_advance(&sim);
+        if (steps > 0 && game_step(&game, INPUT_NONE, steps * SIM_STEP_MS))
         {
-            Tetromino temp = current;
-            temp.y++;
-
-            if (check_collision(&temp))
-            {
-                merge_tetromino(&current);
-
-                int cleared = clear_lines();
-                if (cleared > 0)
-                {
-                    lines_cleared += cleared;
-                    score += cleared * cleared * 100;
-                    level = 1 + lines_cleared / 10;
-                    fall_speed = 300000 - (level - 1) * 25000;
-                    if (fall_speed < 80000)
-                        fall_speed = 80000;
-                }
-                current = create_tetromino();
-
-                if (check_collision(&current))
-                {
-                    game_over = 1;
-                }
-            }
-            else
-            {
-                current = temp;
-            }
-
-            last_fall = now;
             needs_redraw = 1;
         }
 
-        if (needs_redraw && (now - last_draw) * 1000000 / CLOCKS_PER_SEC >= draw_interval)
+        // Alle Eingaben eines Aufwachens landen in einem Frame
+        int64_t t_publish = trace_now();
+        stats_record(STATS_SIM, t_publish - t_sim);
+        trace_complete("Schwerkraft", t_sim, t_publish);
+        if (needs_redraw)
         {
-            draw_board(&current);
-            last_draw = now;
+            render_publish(render, &game, key_read_ns);
+            trace_complete("Frame übergeben", t_publish, trace_now());
             needs_redraw = 0;
         }
-
-        usleep(500);
+        key_read_ns = 0;
     }
 
+    render_thread_stop(render);
+
     printf("\033[?25h");
 
     clear_screen();
@@ -530,12 +200,17 @@ int main()
     printf("  ╔══════════════════════════════════════╗\n");
     printf("  ║           GAME OVER!                 ║\n");
     printf("  ╠══════════════════════════════════════╣\n");
-    printf("  ║  Final Score: %-21d ║\n", score);
-    printf("  ║  Level: %-28d ║\n", level);
-    printf("  ║  Lines: %-28d ║\n", lines_cleared);
+    printf("  ║  Final Score: %-21d ║\n", game.score);
+    printf("  ║  Level: %-28d ║\n", game.level);
+    printf("  ║  Lines: %-28d ║\n", game.lines_cleared);
+    printf("  ║  Seed: %-29llu ║\n", (unsigned long long)game.seed);
     printf("  ╚══════════════════════════════════════╝\n\n");
 
+    input_thread_stop(input);
     disable_raw_mode();
 
+    replay_close(replay);
+    stats_finish();
+    trace_close();
     return 0;
 }